@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "logic/Cpalindromer.h"
+
+// Checks that a batched query finds exactly what searching each seed on its
+// own finds, with seeds that are not dictionary words (which must not see
+// each other) mixed with words, prefixes of each other and short seeds.
+// Usage: batch_test
+
+#define TEST_MIN_WORD_LEN 4
+#define TEST_OUTPUT "test_output.txt"
+
+typedef struct {
+    int depth;
+    const char* seeds[8];
+    int seed_count;
+} BatchCase;
+
+static BatchCase cases[] = {
+    { 4, { "qqzy", "yzqq" }, 2 },
+    { 4, { "st", "sto", "stop", "stopp", "re", "red", "redr" }, 7 },
+    { 4, { "level", "leveled", "levels", "lev", "leve" }, 5 },
+};
+
+typedef struct {
+    char** lines;
+    int count;
+    int capacity;
+} LineList;
+
+static void line_list_add(LineList* list, const char* line) {
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->lines = realloc(list->lines, sizeof(char*) * list->capacity);
+        if (!list->lines) {
+            fprintf(stderr, "Memory allocation failed for test lines\n");
+            exit(1);
+        }
+    }
+    list->lines[list->count] = strdup(line);
+    if (!list->lines[list->count]) {
+        fprintf(stderr, "Memory allocation failed for test lines\n");
+        exit(1);
+    }
+    list->count++;
+}
+
+static void line_list_free(LineList* list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->lines[i]);
+    }
+    free(list->lines);
+}
+
+static int compare_lines(const void* a, const void* b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+// Append every line of the output file, prefixed with tag when given
+static void read_output(const char* tag, LineList* list) {
+    FILE* file = fopen(TEST_OUTPUT, "r");
+    if (!file) return;
+
+    char line[MAX_LINE_LEN * 2];
+    char tagged[MAX_LINE_LEN * 2 + MAX_WORD_LEN + 4];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (tag) {
+            snprintf(tagged, sizeof(tagged), "[%s] %s", tag, line);
+            line_list_add(list, tagged);
+        } else {
+            line_list_add(list, line);
+        }
+    }
+    fclose(file);
+}
+
+// Run one case both ways and compare the sorted outputs and per-seed counts
+static bool run_case(BatchCase* test) {
+    int batch_counts[8];
+    LineList batch = { NULL, 0, 0 };
+    LineList looped = { NULL, 0, 0 };
+    bool counts_match = true;
+
+    palindrome_set_max_depth(test->depth);
+
+    palindrome_set_output_file(TEST_OUTPUT);
+    int batch_found = palindrome_find_batch(test->seeds, test->seed_count, batch_counts);
+    read_output(NULL, &batch);
+
+    int looped_found = 0;
+    for (int i = 0; i < test->seed_count; i++) {
+        palindrome_set_output_file(TEST_OUTPUT);
+        int found = palindrome_find_all(test->seeds[i]);
+        read_output(test->seeds[i], &looped);
+        looped_found += found;
+        counts_match = counts_match && found == batch_counts[i];
+    }
+
+    qsort(batch.lines, batch.count, sizeof(char*), compare_lines);
+    qsort(looped.lines, looped.count, sizeof(char*), compare_lines);
+    bool lines_match = batch.count == looped.count;
+    for (int i = 0; lines_match && i < batch.count; i++) {
+        lines_match = strcmp(batch.lines[i], looped.lines[i]) == 0;
+    }
+
+    printf("depth %d, %d seeds: batch %d, looped %d%s\n", test->depth, test->seed_count,
+           batch_found, looped_found,
+           counts_match && lines_match ? "" : "  (results differ)");
+
+    line_list_free(&batch);
+    line_list_free(&looped);
+    return counts_match && lines_match;
+}
+
+int main(void) {
+    if (!palindrome_init()) {
+        printf("Error: Failed to initialize palindrome finder\n");
+        return 1;
+    }
+    palindrome_set_min_word_length(TEST_MIN_WORD_LEN);
+
+    if (!palindrome_load_dictionary("lexicons/cel.txt") ||
+        !palindrome_set_output_file(TEST_OUTPUT)) {
+        printf("Error: Failed to set up batch test\n");
+        palindrome_cleanup();
+        return 1;
+    }
+    palindrome_set_echo(false);
+
+    bool passed = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        passed = run_case(&cases[i]) && passed;
+    }
+
+    printf("%s\n", passed ? "batch test passed" : "batch test FAILED");
+    palindrome_cleanup();
+    return passed ? 0 : 1;
+}
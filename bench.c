@@ -0,0 +1,72 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "logic/Cpalindromer.h"
+
+// Times the full search at each depth from 4 to MAX_PALINDROME_LEN, once
+// expanding every candidate at the last level and once resolving it from
+// the closing lists, and checks both find the same palindromes.
+// Usage: bench [min length] [starting word, "0" for none]
+
+#define BENCH_MIN_DEPTH 4
+
+static double seconds_since(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Run one search and return its time in seconds
+static double timed_search(const char* starting_word, bool closing_lists, int* found) {
+    struct timespec start;
+    
+    palindrome_set_closing_lists(closing_lists);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    *found = palindrome_find_all(starting_word);
+    return seconds_since(&start);
+}
+
+int main(int argc, char* argv[]) {
+    int min_word_len = argc > 1 ? atoi(argv[1]) : 5;
+    const char* starting_word = argc > 2 ? argv[2] : "level";
+    if (strcmp(starting_word, "0") == 0) {
+        starting_word = "";
+    }
+    
+    if (!palindrome_init()) {
+        printf("Error: Failed to initialize palindrome finder\n");
+        return 1;
+    }
+    palindrome_set_min_word_length(min_word_len);
+    
+    if (!palindrome_load_dictionary("lexicons/cel.txt") ||
+        !palindrome_set_output_file("bench_output.txt")) {
+        printf("Error: Failed to set up benchmark\n");
+        palindrome_cleanup();
+        return 1;
+    }
+    palindrome_set_echo(false);
+    
+    printf("min length %d, start '%s'\n", min_word_len, starting_word);
+    printf("%5s %10s %12s %12s %8s\n", "depth", "found", "expand (s)", "closing (s)", "speedup");
+    
+    bool consistent = true;
+    for (int depth = BENCH_MIN_DEPTH; depth <= MAX_PALINDROME_LEN; depth++) {
+        palindrome_set_max_depth(depth);
+        
+        int expand_found, closing_found;
+        double expand_time = timed_search(starting_word, false, &expand_found);
+        double closing_time = timed_search(starting_word, true, &closing_found);
+        
+        printf("%5d %10d %12.3f %12.3f %7.2fx%s\n", depth, closing_found, expand_time,
+               closing_time, closing_time > 0 ? expand_time / closing_time : 0.0,
+               expand_found == closing_found ? "" : "  (counts differ)");
+        consistent = consistent && expand_found == closing_found;
+    }
+    
+    palindrome_cleanup();
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "logic/dictionary.h"
+
+// Checks live dictionary edits against fresh loads. Words are removed and
+// re-added (and new ones bulk loaded) while a snapshot is pinned; the pinned
+// tries must still match a fresh load of the original list, the current ones
+// a fresh load of the edited list, and releasing the pin must reclaim every
+// old version. In-place trie_remove is checked the same way.
+// Usage: dictionary_test
+
+#define TEST_LEXICON "lexicons/cel.txt"
+#define TEST_REMOVE_EVERY 7     // remove every 7th word...
+#define TEST_READD_EVERY 3      // ...and add every 3rd removed one back
+
+static const char* new_words[] = { "qqzy", "yzqq", "stopp", "redr", "zzyzx" };
+
+typedef struct {
+    char** words;
+    int count;
+    int capacity;
+} WordSet;
+
+static void word_set_add(WordSet* set, const char* word) {
+    if (set->count >= set->capacity) {
+        set->capacity = set->capacity ? set->capacity * 2 : 1024;
+        set->words = realloc(set->words, sizeof(char*) * set->capacity);
+        if (!set->words) {
+            fprintf(stderr, "Memory allocation failed for test words\n");
+            exit(1);
+        }
+    }
+    set->words[set->count] = strdup(word);
+    if (!set->words[set->count]) {
+        fprintf(stderr, "Memory allocation failed for test words\n");
+        exit(1);
+    }
+    set->count++;
+}
+
+static void word_set_free(WordSet* set) {
+    for (int i = 0; i < set->count; i++) {
+        free(set->words[i]);
+    }
+    free(set->words);
+}
+
+// Lower-cased words of the lexicon that fit the trie alphabet
+static bool read_lexicon(const char* filename, WordSet* set) {
+    FILE* file = fopen(filename, "r");
+    if (!file) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n\r")] = '\0';
+        for (int i = 0; line[i]; i++) {
+            if (line[i] >= 'A' && line[i] <= 'Z') line[i] += 'a' - 'A';
+        }
+        if (line[0] && trie_in_alphabet(line)) {
+            word_set_add(set, line);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static Dictionary* fresh_dictionary(const WordSet* set) {
+    Dictionary* dictionary = dictionary_create();
+    if (!dictionary) {
+        fprintf(stderr, "Memory allocation failed for test dictionary\n");
+        exit(1);
+    }
+    dictionary_load_begin(dictionary);
+    for (int i = 0; i < set->count; i++) {
+        dictionary_load_word(dictionary, set->words[i]);
+    }
+    dictionary_load_end(dictionary);
+    return dictionary;
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+// Closing lists hold ids, which differ between dictionaries, so compare the
+// words they name
+static bool same_closing(const TrieNode* a, const WordTable* words_a,
+                         const TrieNode* b, const WordTable* words_b) {
+    if (a->closing_count != b->closing_count) return false;
+    if (a->closing_count == 0) return true;
+
+    const char** texts_a = malloc(sizeof(char*) * a->closing_count);
+    const char** texts_b = malloc(sizeof(char*) * b->closing_count);
+    if (!texts_a || !texts_b) {
+        fprintf(stderr, "Memory allocation failed for closing lists\n");
+        exit(1);
+    }
+    for (int i = 0; i < a->closing_count; i++) {
+        texts_a[i] = word_table_get(words_a, a->closing_ids[i]);
+        texts_b[i] = word_table_get(words_b, b->closing_ids[i]);
+    }
+    qsort(texts_a, a->closing_count, sizeof(char*), compare_strings);
+    qsort(texts_b, b->closing_count, sizeof(char*), compare_strings);
+
+    bool same = true;
+    for (int i = 0; same && i < a->closing_count; i++) {
+        same = strcmp(texts_a[i], texts_b[i]) == 0;
+    }
+    free(texts_a);
+    free(texts_b);
+    return same;
+}
+
+// Walk two tries together: same shape, same words, same closing lists
+static bool same_trie(const TrieNode* a, const WordTable* words_a,
+                      const TrieNode* b, const WordTable* words_b) {
+    if (a->is_word_end != b->is_word_end) return false;
+    if (a->is_word_end &&
+        strcmp(word_table_get(words_a, a->word_id), word_table_get(words_b, b->word_id)) != 0) {
+        return false;
+    }
+    if (!same_closing(a, words_a, b, words_b)) return false;
+
+    for (int i = 0; i < trie_alphabet_size(); i++) {
+        if (!a->children[i] != !b->children[i]) return false;
+        if (a->children[i] && !same_trie(a->children[i], words_a, b->children[i], words_b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool same_version(const DictionarySnapshot* a, const WordTable* words_a,
+                         const DictionarySnapshot* b, const WordTable* words_b) {
+    return same_trie(a->forward, words_a, b->forward, words_b) &&
+           same_trie(a->reverse, words_a, b->reverse, words_b);
+}
+
+static bool report(const char* check, bool passed) {
+    printf("%-44s %s\n", check, passed ? "ok" : "FAILED");
+    return passed;
+}
+
+int main(void) {
+    WordSet original = { NULL, 0, 0 };
+    if (!read_lexicon(TEST_LEXICON, &original)) {
+        printf("Error: Cannot open dictionary file %s\n", TEST_LEXICON);
+        return 1;
+    }
+
+    // Edited list: every 7th word removed, every 3rd of those added back,
+    // then the new words
+    WordSet removed = { NULL, 0, 0 };
+    WordSet edited = { NULL, 0, 0 };
+    for (int i = 0; i < original.count; i++) {
+        if (i % TEST_REMOVE_EVERY == 0) {
+            word_set_add(&removed, original.words[i]);
+            if (removed.count % TEST_READD_EVERY == 0) {
+                word_set_add(&edited, original.words[i]);
+            }
+        } else {
+            word_set_add(&edited, original.words[i]);
+        }
+    }
+    for (size_t i = 0; i < sizeof(new_words) / sizeof(new_words[0]); i++) {
+        word_set_add(&edited, new_words[i]);
+    }
+
+    Dictionary* dictionary = fresh_dictionary(&original);
+    int interned = dictionary->words->count;
+    DictionarySnapshot* pinned = dictionary_acquire(dictionary);
+
+    bool edits_applied = true;
+    for (int i = 0; i < removed.count; i++) {
+        edits_applied = dictionary_remove_word(dictionary, removed.words[i]) && edits_applied;
+    }
+    for (int i = 0; i < removed.count; i++) {
+        if ((i + 1) % TEST_READD_EVERY == 0) {
+            edits_applied = dictionary_add_word(dictionary, removed.words[i]) && edits_applied;
+        }
+    }
+    dictionary_load_begin(dictionary);
+    for (size_t i = 0; i < sizeof(new_words) / sizeof(new_words[0]); i++) {
+        edits_applied = dictionary_load_word(dictionary, new_words[i]) && edits_applied;
+    }
+    edits_applied = dictionary_load_end(dictionary) && edits_applied;
+
+    printf("%d words, %d removed, %d added back, %d new\n", original.count, removed.count,
+           removed.count / TEST_READD_EVERY, (int) (sizeof(new_words) / sizeof(new_words[0])));
+
+    bool passed = report("every edit applied", edits_applied);
+
+    Dictionary* before = fresh_dictionary(&original);
+    passed = report("pinned snapshot matches the original list",
+                    same_version(pinned, dictionary->words, before->current, before->words)) &&
+             passed;
+
+    Dictionary* after = fresh_dictionary(&edited);
+    DictionarySnapshot* current = dictionary_acquire(dictionary);
+    passed = report("current version matches the edited list",
+                    same_version(current, dictionary->words, after->current, after->words)) &&
+             passed;
+    dictionary_release(dictionary, current);
+
+    passed = report("re-added words reuse their ids",
+                    dictionary->words->count == interned + (int) (sizeof(new_words) /
+                                                                  sizeof(new_words[0]))) &&
+             passed;
+
+    dictionary_release(dictionary, pinned);
+    passed = report("releasing the pin reclaims old versions",
+                    dictionary->oldest == dictionary->current) && passed;
+
+    // In place: remove the same words from the fresh original tries
+    DictionarySnapshot* plain = before->current;
+    bool removed_in_place = true;
+    for (int i = 0; i < removed.count; i++) {
+        char* reversed = strdup(removed.words[i]);
+        int len = strlen(reversed);
+        for (int j = 0; j < len / 2; j++) {
+            char c = reversed[j];
+            reversed[j] = reversed[len - 1 - j];
+            reversed[len - 1 - j] = c;
+        }
+        removed_in_place = trie_remove(plain->forward, removed.words[i]) &&
+                           trie_remove(plain->reverse, reversed) && removed_in_place;
+        free(reversed);
+    }
+    WordSet kept = { NULL, 0, 0 };
+    for (int i = 0; i < original.count; i++) {
+        if (i % TEST_REMOVE_EVERY != 0) {
+            word_set_add(&kept, original.words[i]);
+        }
+    }
+    Dictionary* expected = fresh_dictionary(&kept);
+    passed = report("in-place removal matches the kept list",
+                    removed_in_place &&
+                    same_version(plain, before->words, expected->current, expected->words)) &&
+             passed;
+
+    printf("%s\n", passed ? "dictionary test passed" : "dictionary test FAILED");
+
+    dictionary_destroy(expected);
+    dictionary_destroy(after);
+    dictionary_destroy(before);
+    dictionary_destroy(dictionary);
+    word_set_free(&kept);
+    word_set_free(&edited);
+    word_set_free(&removed);
+    word_set_free(&original);
+    return passed ? 0 : 1;
+}
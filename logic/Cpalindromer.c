@@ -7,19 +7,34 @@
 #include "Cpalindromer.h"
 
 // Global variables (static for encapsulation)
-static TrieNode* dictionary_root = NULL;
-static TrieNode* reverse_dictionary_root = NULL;
+static Dictionary* dictionary = NULL;
 static int MIN_WORD_LEN = 6;
 static FILE* output_file = NULL;
 static int palindrome_count = 0;
+static ResultQueue* result_queue = NULL;
+static ResultQueuePolicy output_policy = RESULT_POLICY_BLOCK;
+static int max_depth = MAX_PALINDROME_LEN;
+static bool use_closing_lists = true;
+
+// Tries seen by the running search: the pinned snapshot plus the starting word
+static DictionarySnapshot* search_snapshot = NULL;
+static TrieUpdate search_update;
+static TrieNode* dictionary_root = NULL;
+static TrieNode* reverse_dictionary_root = NULL;
+
+// Text of the query-local ids (-2 - index) of the running search
+static WordList* query_words = NULL;
+
+static int format_palindrome(const PalindromeResult* result, char* out, int out_size);
 
 // Initialize the palindrome finder
 bool palindrome_init(void) {
-    dictionary_root = trie_create();
-    reverse_dictionary_root = trie_create();
+    dictionary = dictionary_create();
+    result_queue = result_queue_create(output_policy, format_palindrome);
+    query_words = wordlist_create(1000);
     palindrome_count = 0;
     
-    if (!dictionary_root || !reverse_dictionary_root) {
+    if (!dictionary || !result_queue) {
         palindrome_cleanup();
         return false;
     }
@@ -27,46 +42,19 @@ bool palindrome_init(void) {
     return true;
 }
 
-void cleanUp(char* str) {
-    if (!str) return;
-    
-    int len = strlen(str);
-    int half = len / 2;
-    int writePos = 0;
-    
-    for (int pos = 0; pos < len; pos++) {
-        char ch = str[pos];
-        
-        if (pos < half) {
-            // First half: '1' -> space, '2' -> skip, others -> keep
-            if (ch == '1') {
-                str[writePos++] = ' ';
-            } else if (ch != '2') {
-                str[writePos++] = ch;
-            }
-        } else {
-            // Second half: '1' -> skip, '2' -> space, others -> keep
-            if (ch == '2') {
-                str[writePos++] = ' ';
-            } else if (ch != '1') {
-                str[writePos++] = ch;
-            }
-        }
-    }
-    
-    str[writePos] = '\0';  // Null terminate at new length
-}
-
-
 // Cleanup resources
 void palindrome_cleanup(void) {
-    if (dictionary_root) {
-        trie_destroy(dictionary_root);
-        dictionary_root = NULL;
+    if (result_queue) {
+        result_queue_destroy(result_queue);
+        result_queue = NULL;
     }
-    if (reverse_dictionary_root) {
-        trie_destroy(reverse_dictionary_root);
-        reverse_dictionary_root = NULL;
+    if (dictionary) {
+        dictionary_destroy(dictionary);
+        dictionary = NULL;
+    }
+    if (query_words) {
+        wordlist_free(query_words);
+        query_words = NULL;
     }
     if (output_file) {
         fclose(output_file);
@@ -81,14 +69,54 @@ void palindrome_set_min_word_length(int min_len) {
 
 // Set output file
 bool palindrome_set_output_file(const char* filename) {
+    // Detach the writer (draining anything pending) before swapping files
+    result_queue_set_sink(result_queue, NULL);
     if (output_file) {
         fclose(output_file);
     }
     
     output_file = fopen(filename, "w");
+    result_queue_set_sink(result_queue, output_file);
     return output_file != NULL;
 }
 
+// Set what the search does when the writer falls behind
+void palindrome_set_output_policy(ResultQueuePolicy policy) {
+    output_policy = policy;
+    result_queue_set_policy(result_queue, policy);
+}
+
+// Set how many words may follow the starting word (1 to MAX_PALINDROME_LEN)
+void palindrome_set_max_depth(int depth) {
+    if (depth < 1) depth = 1;
+    if (depth > MAX_PALINDROME_LEN) depth = MAX_PALINDROME_LEN;
+    max_depth = depth;
+}
+
+// Resolve the last word of each palindrome from the tries' closing lists
+// (the default) or by expanding every candidate, for comparison
+void palindrome_set_closing_lists(bool enabled) {
+    use_closing_lists = enabled;
+}
+
+// Echo results to stdout as well as the output file (on by default)
+void palindrome_set_echo(bool echo) {
+    result_queue_set_echo(result_queue, echo);
+}
+
+// Print queue depth, backpressure and writer latency for the last search
+void palindrome_print_output_stats(void) {
+    if (!result_queue) return;
+
+    ResultQueueStats stats;
+    result_queue_get_stats(result_queue, &stats);
+
+    printf("Output: %ld written in %ld batches, %ld dropped, %ld spilled, %ld blocked\n",
+           stats.written, stats.batches, stats.dropped, stats.spilled, stats.blocked);
+    printf("Queue depth: avg %.1f, max %ld; writer latency: avg %.1fus, max %.1fus\n",
+           stats.avg_depth, stats.max_depth, stats.avg_latency_us, stats.max_latency_us);
+}
+
 // Utility function: reverse a string
 char* string_reverse(const char* str) {
     int len = strlen(str);
@@ -125,45 +153,74 @@ void get_prefixes(const char* word, WordList* result) {
     }
 }
 
-// Generate candidate words for given prefix and direction
-void generate_candidates(const char* prefix, bool is_forwards, WordList* candidates) {
-    candidates->count = 0;  // Reset list
-    
-    if (is_forwards) {
-        // Get words starting with prefix from normal dictionary
-        trie_get_words_with_prefix(dictionary_root, prefix, candidates);
-        
-        // Also add prefixes of current prefix that are valid reverse words
-        WordList* prefixes = wordlist_create(strlen(prefix));
-        get_prefixes(prefix, prefixes);
-        
-        for (int i = 0; i < prefixes->count; i++) {
-            // char* reversed = string_reverse(prefixes->words[i]);
-            if (trie_search(dictionary_root, prefixes->words[i])) {
-                wordlist_add(candidates, prefixes->words[i]);
-            }
-        }
-        wordlist_free(prefixes);
+// Text of a dictionary word or of a query-local word
+static inline const char* word_text(int word_id) {
+    if (word_id >= 0) {
+        return word_table_get(dictionary->words, word_id);
+    }
+    return wordlist_get(query_words, -2 - word_id);
+}
+
+static inline int word_length(int word_id) {
+    if (word_id >= 0) {
+        return word_table_length(dictionary->words, word_id);
+    }
+    return wordlist_length(query_words, -2 - word_id);
+}
 
+// Keep text for the running query and return its id. The writer thread
+// reads query words, so only add them before the search emits anything.
+static int add_query_word(const char* word, int length) {
+    wordlist_add_n(query_words, word, length);
+    return -1 - query_words->count;
+}
+
+// Copy the referenced text to out (back to front if backwards) and return its length
+static int text_copy(const TextRef* ref, bool backwards, char* out) {
+    const char* word = word_text(ref->word_id);
+    int word_len = word_length(ref->word_id);
+    int len = word_len - ref->offset;
+
+    if (ref->reversed == backwards) {
+        // A reversed suffix read backwards is the word's own prefix
+        memcpy(out, ref->reversed ? word : word + ref->offset, len);
     } else {
+        const char* end = ref->reversed ? word + len : word + word_len;
+        for (int i = 0; i < len; i++) {
+            out[i] = end[-1 - i];
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
 
-        trie_get_words_with_prefix(reverse_dictionary_root, prefix, candidates);
-        WordList* prefixes = wordlist_create(strlen(prefix));
-        get_prefixes(prefix, prefixes);
-        for (int i = 0; i < prefixes->count; i++) {
-            if (trie_search(reverse_dictionary_root, prefixes->words[i])) {
-                wordlist_add(candidates, prefixes->words[i]);
-            }
+// Generate candidate words for given prefix and direction. Backwards
+// candidates come from the reverse dictionary, so their text is reversed.
+void generate_candidates(const char* prefix, bool is_forwards, IdList* candidates) {
+    TrieNode* root = is_forwards ? dictionary_root : reverse_dictionary_root;
+    idlist_reset(candidates);
+    
+    // Words starting with the prefix
+    trie_get_ids_with_prefix(root, prefix, candidates);
+    
+    // Also words the prefix itself starts with
+    int lengths[MAX_TEXT_LEN + 1];
+    int word_ids[MAX_TEXT_LEN + 1];
+    int len = strlen(prefix);
+    int count = trie_get_prefix_words(root, prefix, lengths, word_ids);
+    
+    for (int i = 0; i < count; i++) {
+        if (lengths[i] > 0 && lengths[i] < len) {
+            idlist_add(candidates, word_ids[i]);
         }
-        wordlist_free(prefixes);
     }
 }
 
-void generate_starts(const char* starting_prefix, WordList* candidates) {
-    candidates->count = 0;
+void generate_starts(const char* starting_prefix, IdList* candidates) {
+    idlist_reset(candidates);
     
     // Get words that directly match the prefix
-    trie_get_words_with_prefix(dictionary_root, starting_prefix, candidates);
+    trie_get_ids_with_prefix(dictionary_root, starting_prefix, candidates);
     
     // Pre-calculate starting_prefix length to avoid repeated strlen calls
     const size_t prefix_len = strlen(starting_prefix);
@@ -173,199 +230,802 @@ void generate_starts(const char* starting_prefix, WordList* candidates) {
     get_prefixes(starting_prefix, prefixes);
     
     // Pre-allocate buffer for combined words outside the loop
-    char combined[MAX_WORD_LEN * 2];
+    char combined[MAX_TEXT_LEN];
     
-    // Create completion_words once and reuse it
-    WordList* completion_words = wordlist_create(1000);
+    // Create completion_ids once and reuse it
+    IdList* completion_ids = idlist_create(1000);
     
     for (int i = 0; i < prefixes->count; i++) {
-        const char* prefix = prefixes->words[i];
+        const char* prefix = wordlist_get(prefixes, i);
         if (trie_search(dictionary_root, prefix)) {
             const size_t curr_prefix_len = strlen(prefix);
             
-            
             // Calculate remaining string pointer once
             const char* remaining = starting_prefix + curr_prefix_len;
             
-            // Clear the reused WordList instead of creating new one
-            completion_words->count = 0;
-            trie_get_words_with_prefix(dictionary_root, remaining, completion_words);
+            // Clear the reused IdList instead of creating new one
+            idlist_reset(completion_ids);
+            trie_get_ids_with_prefix(dictionary_root, remaining, completion_ids);
             
-            // Batch process combinations
-            for (int j = 0; j < completion_words->count; j++) {
-                const char* completion = completion_words->words[j];
+            // Each combination becomes a query word of its own
+            for (int j = 0; j < completion_ids->count; j++) {
+                int completion = completion_ids->ids[j];
+                int completion_len = word_length(completion);
                 
-                // Use memcpy for potentially better performance than snprintf
                 memcpy(combined, prefix, curr_prefix_len);
-                strcpy(combined + curr_prefix_len, completion);
+                memcpy(combined + curr_prefix_len, word_text(completion), completion_len);
                 
-                wordlist_add(candidates, combined);
+                idlist_add(candidates, add_query_word(combined, curr_prefix_len + completion_len));
             }
         }
     }
     
     // Clean up
-    wordlist_free(completion_words);
+    idlist_free(completion_ids);
     wordlist_free(prefixes);
 }
 
-// Output a found palindrome
-void output_palindrome(const char* settled, const char* middle, bool was_forwards) {
-    // Create the full palindrome
+// Append text to a line being rendered, as far as it fits
+static void append_text(char* out, int* pos, int out_size, const char* text, int len) {
+    if (len > out_size - 1 - *pos) {
+        len = out_size - 1 - *pos;
+    }
+    if (len <= 0) return;
+    
+    memcpy(out + *pos, text, len);
+    *pos += len;
+    out[*pos] = '\0';
+}
 
+// Render a raw result into its final text (runs on the writer thread). The
+// left side is the settled pieces, with a word break before each piece
+// settled going forwards; the right side mirrors it, with a break after
+// each piece settled going backwards.
+static int format_palindrome(const PalindromeResult* result, char* out, int out_size) {
+    const SearchState* state = &result->state;
+    char text[MAX_TEXT_LEN + 1];
+    int pos = 0;
+    out[0] = '\0';
 
-    char palindrome[MAX_WORD_LEN * MAX_PALINDROME_LEN];
+    // Batch results are prefixed with the seed they belong to
+    if (result->tag) {
+        pos = snprintf(out, out_size, "[%s] ", result->tag);
+        if (pos >= out_size) pos = out_size - 1;
+    }
 
-    char* reversed = string_reverse(settled);
+    for (int i = 0; i < state->depth; i++) {
+        if (state->forwards_pieces & (1u << i)) {
+            append_text(out, &pos, out_size, " ", 1);
+        }
+        append_text(out, &pos, out_size, text, text_copy(&state->pieces[i], false, text));
+    }
 
-    if (was_forwards) {
-        snprintf(palindrome, sizeof(palindrome), "%s %s%s", settled, middle, reversed);
+    int middle_len = text_copy(&state->overhang, false, text);
+    if (state->is_forwards) {
+        append_text(out, &pos, out_size, " ", 1);
+        append_text(out, &pos, out_size, text, middle_len);
     } else {
-        snprintf(palindrome, sizeof(palindrome), "%s%s %s", settled, middle, reversed);
+        append_text(out, &pos, out_size, text, middle_len);
+        append_text(out, &pos, out_size, " ", 1);
     }
 
-    cleanUp(palindrome);
-    
-    // Write to file if output file is set
-    if (output_file) {
-        fprintf(output_file, "%s\n", palindrome);
-        fflush(output_file);
+    for (int i = state->depth - 1; i >= 0; i--) {
+        append_text(out, &pos, out_size, text, text_copy(&state->pieces[i], true, text));
+        if (!(state->forwards_pieces & (1u << i))) {
+            append_text(out, &pos, out_size, " ", 1);
+        }
+    }
+
+    return pos;
+}
+
+// Hand a result to the writer thread; tag is NULL outside batch queries.
+// Only results the queue accepts are counted, so dropped ones never are.
+static bool publish_palindrome(const SearchState* state, const char* tag) {
+    PalindromeResult result;
+
+    result.state = *state;
+    result.tag = tag;
+
+    if (!result_queue_publish(result_queue, &result)) {
+        return false;
     }
-    
     palindrome_count++;
-    printf("Found: %s\n", palindrome);
+    return true;
 }
 
-// Main palindrome search - iterative with explicit stack
-bool find_palindromes(const char* starting_prefix) {
-    // Stack for iterative backtracking
-    SearchState stack[STACK_SIZE];
-    int stack_top = 0;
-    
-    // Initialize with starting state
-    WordList* initial_candidates = wordlist_create(1000);
+// Output a found palindrome; rendering and I/O happen on the writer thread
+void output_palindrome(const SearchState* state) {
+    publish_palindrome(state, NULL);
+}
+
+// Collect the first overhangs for a search; NULL if there are none
+static IdList* collect_initial_candidates(const char* starting_prefix) {
+    IdList* initial_candidates = idlist_create(1000);
 
     if (starting_prefix[0] == '\0') {
         // If no prefix, start from *all words* in the dictionary
-        trie_get_all_words(dictionary_root, initial_candidates);
+        trie_get_ids_with_prefix(dictionary_root, "", initial_candidates);
 
     } else {
         generate_starts(starting_prefix, initial_candidates);
     }
     
-    
     if (initial_candidates->count == 0) {
         printf("No words found starting with '%s'\n", starting_prefix);
-        wordlist_free(initial_candidates);
+        idlist_free(initial_candidates);
+        return NULL;
+    }
+
+    return initial_candidates;
+}
+
+// State before any word is placed: the whole start word overhangs
+static void init_state(int word_id, SearchState* state) {
+    state->overhang.word_id = word_id;
+    state->overhang.offset = 0;
+    state->overhang.reversed = false;
+    state->forwards_pieces = 0;
+    state->depth = 0;
+    state->is_forwards = false;
+}
+
+// Apply a candidate word to a state: the shorter of word and overhang is
+// settled as the next piece, the rest of the longer one overhangs
+static void extend_state(const SearchState* state, int overhang_len, int word_id,
+                         SearchState* next) {
+    // Backwards candidates are read from the reverse dictionary
+    TextRef word = { word_id, 0, !state->is_forwards };
+    int piece = state->depth;
+
+    *next = *state;
+    if (word_length(word_id) >= overhang_len) {
+        next->pieces[piece] = state->overhang;
+        next->overhang = word;
+        next->overhang.offset = overhang_len;
+        next->is_forwards = !state->is_forwards;
+    } else {
+        next->pieces[piece] = word;
+        next->overhang.offset += word_length(word_id);
+    }
+
+    if (state->is_forwards) {
+        next->forwards_pieces |= 1u << piece;
+    } else {
+        next->forwards_pieces &= ~(1u << piece);
+    }
+    next->depth = state->depth + 1;
+}
+
+// Settings shared by every state of one depth-limited pass
+typedef struct {
+    int limit;                  // deepest level explored
+    bool emit_shallower;        // also emit palindromes completing above the limit
+    SearchMemo* memo;
+    const int* tags;            // batch seed groups credited with each result, or NULL
+    int tag_count;
+    const char** group_seeds;   // seed text of each batch group
+    int* group_counts;          // results credited to each batch group
+} SearchPass;
+
+typedef enum {
+    OUTCOME_FOUND,      // a palindrome completes somewhere within the budget
+    OUTCOME_CUTOFF,     // nothing within the budget, but the limit cut branches off
+    OUTCOME_DEAD        // every branch ends without a palindrome at any depth
+} SearchOutcome;
+
+// Emit a result once per seed tag (untagged outside batch queries, or
+// when there is no pass at all)
+static void emit_palindrome(const SearchPass* pass, const SearchState* state) {
+    if (!pass || !pass->tags) {
+        output_palindrome(state);
+        return;
+    }
+
+    for (int i = 0; i < pass->tag_count; i++) {
+        int group = pass->tags[i];
+        if (publish_palindrome(state, pass->group_seeds[group])) {
+            pass->group_counts[group]++;
+        }
+    }
+}
+
+// Resolve the last level of a search without making child states: emit
+// every palindrome that one more word completes. The overhang's own word
+// and longer words come straight from its trie node; words the overhang
+// starts with close it when the rest of it is a palindrome.
+static SearchOutcome close_state(const SearchState* state, const char* overhang,
+                                 int overhang_len, const SearchPass* pass) {
+    TrieNode* root = state->is_forwards ? dictionary_root : reverse_dictionary_root;
+    SearchState next;
+    bool found = false;
+
+    // Tries are pruned on removal, so any node still leads to some word
+    TrieNode* node = trie_get_prefix_node(root, overhang);
+    bool extended = node != NULL;
+
+    if (node) {
+        // The overhang itself is a word: nothing is left over
+        if (node->is_word_end) {
+            extend_state(state, overhang_len, node->word_id, &next);
+            emit_palindrome(pass, &next);
+            found = true;
+        }
+        for (int i = 0; i < node->closing_count; i++) {
+            extend_state(state, overhang_len, node->closing_ids[i], &next);
+            emit_palindrome(pass, &next);
+            found = true;
+        }
+    }
+
+    int lengths[MAX_TEXT_LEN + 1];
+    int word_ids[MAX_TEXT_LEN + 1];
+    int count = trie_get_prefix_words(root, overhang, lengths, word_ids);
+
+    for (int i = 0; i < count; i++) {
+        if (lengths[i] == 0 || lengths[i] >= overhang_len) continue;
+
+        extended = true;
+        if (is_palindrome(overhang + lengths[i])) {
+            extend_state(state, overhang_len, word_ids[i], &next);
+            emit_palindrome(pass, &next);
+            found = true;
+        }
+    }
+
+    if (found) return OUTCOME_FOUND;
+    return extended ? OUTCOME_CUTOFF : OUTCOME_DEAD;
+}
+
+// Take a slot on the search stack, growing it when full
+static SearchState* push_state(SearchState** stack, int* stack_top, int* stack_capacity) {
+    if (*stack_top >= *stack_capacity) {
+        *stack_capacity *= 2;
+        *stack = realloc(*stack, sizeof(SearchState) * *stack_capacity);
+        if (!*stack) {
+            fprintf(stderr, "Memory allocation failed for search stack\n");
+            exit(1);
+        }
+    }
+    return &(*stack)[(*stack_top)++];
+}
+
+// Main palindrome search - iterative with explicit stack
+bool find_palindromes(const char* starting_prefix) {
+    // Initialize with starting state
+    IdList* initial_candidates = collect_initial_candidates(starting_prefix);
+    if (!initial_candidates) {
         return false;
     }
     
+    // Stack for iterative backtracking; states are small and fixed-size,
+    // so the stack grows with the frontier instead of capping it
+    int stack_capacity = STACK_SIZE;
+    int stack_top = 0;
+    SearchState* stack = malloc(sizeof(SearchState) * stack_capacity);
+    if (!stack) {
+        fprintf(stderr, "Memory allocation failed for search stack\n");
+        exit(1);
+    }
+    
     // Push initial states for each candidate word
     for (int i = 0; i < initial_candidates->count; i++) {
-        if ((size_t) stack_top >= STACK_SIZE) break;
-        
-        SearchState* state = &stack[stack_top++];
-        state->settled = malloc(MAX_WORD_LEN * MAX_PALINDROME_LEN);
-        state->overhang = malloc(MAX_WORD_LEN * MAX_PALINDROME_LEN);
-        
-        if (!state->settled || !state->overhang) {
-            // Handle allocation failure
-            free(state->settled);
-            free(state->overhang);
-            stack_top--;
-            continue;
-        }
-        
-        strcpy(state->settled, "");
-        strcpy(state->overhang, initial_candidates->words[i]);
-        state->depth = 0;
-        state->is_forwards = false;
+        init_state(initial_candidates->ids[i], push_state(&stack, &stack_top, &stack_capacity));
     }
     
-    wordlist_free(initial_candidates);
+    idlist_free(initial_candidates);
+    
+    IdList* candidates = idlist_create(16);
+    char overhang[MAX_TEXT_LEN + 1];
     
     // Main search loop
-    while (stack_top > 0 && stack_top <= STACK_SIZE) {
+    while (stack_top > 0) {
         SearchState current = stack[--stack_top];
         
-        // Check depth limit
-        if (current.depth > MAX_PALINDROME_LEN) {
-            free(current.settled);
-            free(current.overhang);
+        // Check if overhang is a palindrome
+        int overhang_len = text_copy(&current.overhang, false, overhang);
+        if (current.depth > 0 && is_palindrome(overhang)) {
+            // Found a palindrome!
+            output_palindrome(&current);
             continue;
         }
         
-        // Check if overhang is a palindrome
-        if (is_palindrome(current.overhang) && current.depth > 0 && current.overhang) {
-            // Found a palindrome!
-            output_palindrome(current.settled, current.overhang, current.is_forwards);
-            // if (strlen(current.overhang) > 0) {
-                free(current.settled);
-                free(current.overhang); 
-                continue;
-            // }
+        // Check depth limit; the last level needs no child states
+        if (current.depth >= max_depth) {
+            continue;
+        }
+        if (use_closing_lists && current.depth == max_depth - 1) {
+            close_state(&current, overhang, overhang_len, NULL);
+            continue;
         }
         
         // Generate next candidates
-        WordList* candidates = wordlist_create(1000);
-        generate_candidates(current.overhang, current.is_forwards, candidates);
+        generate_candidates(overhang, current.is_forwards, candidates);
         
         // Try each candidate
-        for (int i = 0; i < candidates->count && (size_t) stack_top < STACK_SIZE; i++) {
-
-            SearchState* new_state = &stack[stack_top++];
-            new_state->settled = malloc(MAX_WORD_LEN * MAX_PALINDROME_LEN);
-            new_state->overhang = malloc(MAX_WORD_LEN);
-            if (!new_state->settled || !new_state->overhang) {
-                // Handle allocation failure
-                free(new_state->settled);
-                free(new_state->overhang);
-                stack_top--;
-                continue;
-            }
+        for (int i = 0; i < candidates->count; i++) {
+            extend_state(&current, overhang_len, candidates->ids[i],
+                         push_state(&stack, &stack_top, &stack_capacity));
+        }
+    }
+
+    idlist_free(candidates);
+    free(stack);
+    return palindrome_count > 0;
+}
+
+// Depth-limited search. In iterative deepening only palindromes completing
+// exactly at the limit are emitted, since shallower ones were emitted by
+// earlier passes. Dead ends and expansions are remembered in the memo.
+static SearchOutcome deepen(const SearchState* state, const SearchPass* pass) {
+    SearchMemo* memo = pass->memo;
+    bool is_forwards = state->is_forwards;
+    int depth = state->depth;
+
+    char overhang[MAX_TEXT_LEN + 1];
+    int overhang_len = text_copy(&state->overhang, false, overhang);
+
+    if (depth > 0 && is_palindrome(overhang)) {
+        if (depth == pass->limit || pass->emit_shallower) {
+            emit_palindrome(pass, state);
+        }
+        return OUTCOME_FOUND;
+    }
+    if (depth == pass->limit) {
+        return OUTCOME_CUTOFF;
+    }
+
+    int budget = pass->limit - depth;
+    int dead_budget = search_memo_dead_budget(memo, overhang, is_forwards);
+    if (dead_budget >= budget) {
+        memo->dead_hits++;
+        return dead_budget >= MEMO_DEAD_FOREVER ? OUTCOME_DEAD : OUTCOME_CUTOFF;
+    }
 
-            const char* word = candidates->words[i];
+    SearchOutcome outcome = OUTCOME_DEAD;
 
-            const char* shorterPrefix;
-            const char* longerPrefix;
+    if (use_closing_lists && budget == 1) {
+        // One word to go: answered by the closing lists
+        outcome = close_state(state, overhang, overhang_len, pass);
+    } else {
+        // Reuse the expansion from an earlier pass when it was cached
+        IdList* candidates = search_memo_candidates(memo, overhang, is_forwards);
+        bool owned = false;
+        if (!candidates) {
+            candidates = idlist_create(16);
+            generate_candidates(overhang, is_forwards, candidates);
+            owned = !search_memo_store_candidates(memo, overhang, is_forwards, candidates);
+        }
 
-            // Determine which is shorter/longer
-            if (strlen(word) >= strlen(current.overhang)) {
-                shorterPrefix = current.overhang;
-                longerPrefix = word;
-                new_state->is_forwards = !current.is_forwards;
-            } else {
-                shorterPrefix = word;
-                longerPrefix = current.overhang;
-                new_state->is_forwards = current.is_forwards;
+        SearchState next;
+        for (int i = 0; i < candidates->count; i++) {
+            extend_state(state, overhang_len, candidates->ids[i], &next);
+
+            SearchOutcome child = deepen(&next, pass);
+            if (child == OUTCOME_FOUND) {
+                outcome = OUTCOME_FOUND;
+            } else if (child == OUTCOME_CUTOFF && outcome == OUTCOME_DEAD) {
+                outcome = OUTCOME_CUTOFF;
             }
-            strcpy(new_state->settled, current.settled);      // Copy previous state
+        }
+
+        if (owned) {
+            idlist_free(candidates);
+        }
+    }
+
+    if (outcome == OUTCOME_DEAD) {
+        search_memo_mark_dead(memo, overhang, is_forwards, MEMO_DEAD_FOREVER);
+    } else if (outcome == OUTCOME_CUTOFF) {
+        search_memo_mark_dead(memo, overhang, is_forwards, budget);
+    }
+
+    return outcome;
+}
+
+// Shortest-first search: emits every 2-word palindrome, then 3-word, and so on
+bool find_palindromes_shortest_first(const char* starting_prefix,
+                                     PalindromeLevelCallback on_level, void* context) {
+    IdList* initial_candidates = collect_initial_candidates(starting_prefix);
+    if (!initial_candidates) {
+        return false;
+    }
+
+    SearchMemo* memo = search_memo_create(MEMO_MAX_ENTRIES, MEMO_MAX_CACHED_WORDS);
+    if (!memo) {
+        idlist_free(initial_candidates);
+        return false;
+    }
 
-            char marker[2];
-            if (current.is_forwards) {
-                marker[0] = '1';
-            } else {
-                marker[0] = '2'; 
+    SearchPass pass = { 0, false, memo, NULL, 0, NULL, NULL };
+
+    for (pass.limit = 1; pass.limit <= max_depth; pass.limit++) {
+        int found_before = palindrome_count;
+        bool all_dead = true;
+
+        for (int i = 0; i < initial_candidates->count; i++) {
+            SearchState start;
+            init_state(initial_candidates->ids[i], &start);
+            if (deepen(&start, &pass) != OUTCOME_DEAD) {
+                all_dead = false;
             }
-            marker[1] = '\0';
-            strcat(new_state->settled, marker);
+        }
+
+        // Make this level's results visible before reporting it
+        result_queue_flush(result_queue);
+        if (on_level && !on_level(pass.limit + 1, palindrome_count - found_before, context)) {
+            break;
+        }
+
+        // Deeper passes cannot find anything once every branch has ended
+        if (all_dead) {
+            break;
+        }
+    }
+
+    search_memo_destroy(memo);
+    idlist_free(initial_candidates);
+    return palindrome_count > 0;
+}
+
+// A batch seed and the position it was submitted at
+typedef struct {
+    const char* seed;
+    int index;
+} BatchSeed;
+
+// A starting overhang credited to one seed group
+typedef struct {
+    int candidate;      // index into the batch's candidate list
+    int group;
+} BatchStart;
+
+// A seed split into a dictionary word and a remainder to complete
+typedef struct {
+    const char* seed;
+    int prefix_len;
+    int group;
+} BatchSplit;
+
+static int compare_batch_seeds(const void* a, const void* b) {
+    return strcmp(((const BatchSeed*) a)->seed, ((const BatchSeed*) b)->seed);
+}
+
+static int compare_batch_splits(const void* a, const void* b) {
+    const BatchSplit* left = a;
+    const BatchSplit* right = b;
+    return strcmp(left->seed + left->prefix_len, right->seed + right->prefix_len);
+}
+
+static const IdList* sorting_candidates = NULL;
+
+static int compare_batch_starts(const void* a, const void* b) {
+    const BatchStart* left = a;
+    const BatchStart* right = b;
+    int order = strcmp(word_text(sorting_candidates->ids[left->candidate]),
+                       word_text(sorting_candidates->ids[right->candidate]));
+    if (order != 0) return order;
+    return left->candidate - right->candidate;
+}
+
+static void batch_add_start(BatchStart** starts, int* count, int* capacity,
+                            int candidate, int group) {
+    if (*count >= *capacity) {
+        *capacity *= 2;
+        *starts = realloc(*starts, sizeof(BatchStart) * *capacity);
+        if (!*starts) {
+            fprintf(stderr, "Memory allocation failed for batch starts\n");
+            exit(1);
+        }
+    }
+    (*starts)[*count].candidate = candidate;
+    (*starts)[*count].group = group;
+    (*count)++;
+}
+
+// A seed the dictionary does not already contain, joined to the tries in a
+// version of its own so no other seed can use it as a word or a start
+typedef struct {
+    int group;
+    TrieUpdate update;
+    TrieNode* forward;
+    TrieNode* reverse;
+    IdList* starts;
+} BatchVersion;
+
+// Build a seed's private version and its starts, exactly as a search for
+// that seed alone would; false if the seed leaves the tries unchanged (it is
+// already a word, or too short to join) and can use the shared ones
+static bool batch_version_create(const char* seed, int group, BatchVersion* version) {
+    int seed_len = strlen(seed);
+    if (seed_len < MIN_WORD_LEN) return false;
+
+    trie_update_init(&version->update);
+    int word_id = add_query_word(seed, seed_len);
+    version->forward = trie_insert_cow(dictionary_root, seed, word_id, &version->update);
+    if (version->forward == dictionary_root) {
+        trie_update_discard(&version->update);
+        return false;
+    }
+
+    version->reverse = reverse_dictionary_root;
+    char* reversed_seed = string_reverse(seed);
+    if (reversed_seed) {
+        version->reverse = trie_insert_cow(reverse_dictionary_root, reversed_seed, word_id,
+                                           &version->update);
+        free(reversed_seed);
+    }
+    version->group = group;
+
+    TrieNode* shared_forward = dictionary_root;
+    TrieNode* shared_reverse = reverse_dictionary_root;
+    dictionary_root = version->forward;
+    reverse_dictionary_root = version->reverse;
+
+    version->starts = idlist_create(1000);
+    generate_starts(seed, version->starts);
+
+    dictionary_root = shared_forward;
+    reverse_dictionary_root = shared_reverse;
+    return true;
+}
+
+// Search a private version's starts. It gets a memo of its own, since dead
+// ends and expansions found in one version do not hold in another.
+static void batch_version_search(BatchVersion* version, const char** group_seeds,
+                                 int* group_counts) {
+    TrieNode* shared_forward = dictionary_root;
+    TrieNode* shared_reverse = reverse_dictionary_root;
+    dictionary_root = version->forward;
+    reverse_dictionary_root = version->reverse;
+
+    SearchMemo* memo = search_memo_create(MEMO_MAX_ENTRIES, MEMO_MAX_CACHED_WORDS);
+    if (!memo) {
+        fprintf(stderr, "Memory allocation failed for batch query\n");
+        exit(1);
+    }
+    SearchPass pass = { max_depth, true, memo, &version->group, 1, group_seeds, group_counts };
+
+    for (int i = 0; i < version->starts->count; i++) {
+        SearchState state;
+        init_state(version->starts->ids[i], &state);
+        deepen(&state, &pass);
+    }
 
-            strcat(new_state->settled, shorterPrefix);
-            strcpy(new_state->overhang, longerPrefix + strlen(shorterPrefix));
-            new_state->depth = current.depth + 1;
+    search_memo_destroy(memo);
+    dictionary_root = shared_forward;
+    reverse_dictionary_root = shared_reverse;
+}
+
+// Batched search over many seeds. Seeds that are already words (or too short
+// to join the dictionary) share the tries, so their initial candidates are
+// generated once for all of them: words under any seed come from one walk of
+// a query trie of the seeds, compound starts share their completion lookups,
+// and a start reached from several seeds is searched once with its results
+// tagged for each. These starts share one memo, so common expansions and dead
+// ends are only worked out once. Every other seed is searched in its own
+// version of the tries, so results never depend on the rest of the batch.
+bool find_palindromes_batch(const char** group_seeds, int group_count, int* group_counts) {
+    BatchVersion* versions = malloc(sizeof(BatchVersion) * group_count);
+    bool* has_version = calloc(group_count, sizeof(bool));
+    if (!versions || !has_version) {
+        fprintf(stderr, "Memory allocation failed for batch query\n");
+        exit(1);
+    }
+
+    // All query words are made before the search emits anything
+    int version_count = 0;
+    int version_start_count = 0;
+    for (int g = 0; g < group_count; g++) {
+        if (batch_version_create(group_seeds[g], g, &versions[version_count])) {
+            has_version[g] = true;
+            version_start_count += versions[version_count].starts->count;
+            version_count++;
+        }
+    }
+
+    TrieNode* query = trie_create();
+    for (int g = 0; g < group_count; g++) {
+        if (!has_version[g]) {
+            trie_insert(query, group_seeds[g], g);
+        }
+    }
+
+    IdList* candidates = idlist_create(1000);
+    int start_capacity = 1000;
+    int start_count = 0;
+    BatchStart* starts = malloc(sizeof(BatchStart) * start_capacity);
+    int* lengths = malloc(sizeof(int) * (MAX_TEXT_LEN + 1));
+    int* groups = malloc(sizeof(int) * (MAX_TEXT_LEN + 1));
+    if (!starts || !lengths || !groups) {
+        fprintf(stderr, "Memory allocation failed for batch query\n");
+        exit(1);
+    }
+
+    // Words starting with a seed, tagged with every seed that prefixes them
+    // (the query trie stores each seed's group as its word id)
+    trie_get_ids_with_prefixes(dictionary_root, query, candidates);
+    for (int i = 0; i < candidates->count; i++) {
+        int prefix_count = trie_get_prefix_words(query, word_text(candidates->ids[i]),
+                                                 lengths, groups);
+        for (int j = 0; j < prefix_count; j++) {
+            batch_add_start(&starts, &start_count, &start_capacity, i, groups[j]);
+        }
+    }
+
+    // Compound starts: a word that prefixes the seed, then a word starting
+    // with the rest of the seed. Splits are sorted by that remainder so each
+    // distinct remainder is looked up once.
+    int split_capacity = 1000;
+    int split_count = 0;
+    BatchSplit* splits = malloc(sizeof(BatchSplit) * split_capacity);
+    if (!splits) {
+        fprintf(stderr, "Memory allocation failed for batch query\n");
+        exit(1);
+    }
+
+    for (int g = 0; g < group_count; g++) {
+        const char* seed = group_seeds[g];
+        if (has_version[g] || strlen(seed) >= MAX_WORD_LEN) continue;
+
+        int prefix_count = trie_get_prefix_words(dictionary_root, seed, lengths, NULL);
+        for (int j = 0; j < prefix_count; j++) {
+            int prefix_len = lengths[j];
+            if (prefix_len == 0 || seed[prefix_len] == '\0') continue;
+
+            if (split_count >= split_capacity) {
+                split_capacity *= 2;
+                splits = realloc(splits, sizeof(BatchSplit) * split_capacity);
+                if (!splits) {
+                    fprintf(stderr, "Memory allocation failed for batch query\n");
+                    exit(1);
+                }
             }
-        
-        wordlist_free(candidates);
-        free(current.settled);
-        free(current.overhang);
+            splits[split_count].seed = seed;
+            splits[split_count].prefix_len = prefix_len;
+            splits[split_count].group = g;
+            split_count++;
+        }
     }
+    qsort(splits, split_count, sizeof(BatchSplit), compare_batch_splits);
 
+    IdList* completions = idlist_create(1000);
+    char combined[MAX_TEXT_LEN];
+
+    for (int i = 0; i < split_count; i++) {
+        const char* seed = splits[i].seed;
+        int prefix_len = splits[i].prefix_len;
+        const char* remaining = seed + prefix_len;
+
+        if (i == 0 || strcmp(remaining, splits[i - 1].seed + splits[i - 1].prefix_len) != 0) {
+            idlist_reset(completions);
+            trie_get_ids_with_prefix(dictionary_root, remaining, completions);
+        }
+
+        for (int k = 0; k < completions->count; k++) {
+            int completion = completions->ids[k];
+            int completion_len = word_length(completion);
+
+            memcpy(combined, seed, prefix_len);
+            memcpy(combined + prefix_len, word_text(completion), completion_len);
+            idlist_add(candidates, add_query_word(combined, prefix_len + completion_len));
+            batch_add_start(&starts, &start_count, &start_capacity,
+                            candidates->count - 1, splits[i].group);
+        }
+    }
+    idlist_free(completions);
+    free(splits);
+    free(groups);
+    free(lengths);
+    trie_destroy(query);
+
+    if (start_count + version_start_count == 0) {
+        printf("No words found starting with any of %d seeds\n", group_count);
+    }
+
+    // Bring identical starts together so each is searched once
+    sorting_candidates = candidates;
+    qsort(starts, start_count, sizeof(BatchStart), compare_batch_starts);
+    sorting_candidates = NULL;
+
+    SearchMemo* memo = search_memo_create(MEMO_MAX_ENTRIES, MEMO_MAX_CACHED_WORDS);
+    int* tags = malloc(sizeof(int) * (start_count > 0 ? start_count : 1));
+    if (!memo || !tags) {
+        fprintf(stderr, "Memory allocation failed for batch query\n");
+        exit(1);
+    }
+    SearchPass pass = { max_depth, true, memo, tags, 0, group_seeds, group_counts };
+
+    for (int i = 0; i < start_count; ) {
+        int start_id = candidates->ids[starts[i].candidate];
+        const char* start = word_text(start_id);
+
+        pass.tag_count = 0;
+        int run_end = i;
+        while (run_end < start_count &&
+               strcmp(word_text(candidates->ids[starts[run_end].candidate]), start) == 0) {
+            tags[pass.tag_count++] = starts[run_end].group;
+            run_end++;
+        }
+
+        SearchState state;
+        init_state(start_id, &state);
+        deepen(&state, &pass);
+        i = run_end;
+    }
+
+    free(tags);
+    search_memo_destroy(memo);
+    free(starts);
+    idlist_free(candidates);
+
+    for (int v = 0; v < version_count; v++) {
+        batch_version_search(&versions[v], group_seeds, group_counts);
+        idlist_free(versions[v].starts);
+        trie_update_discard(&versions[v].update);
+    }
+    free(versions);
+    free(has_version);
     return palindrome_count > 0;
 }
 
-// Load dictionary from file
+// Remove newline and convert to lowercase
+static void normalize_line(char* line) {
+    line[strcspn(line, "\n\r")] = 0;
+    
+    for (int i = 0; line[i]; i++) {
+        line[i] = tolower((unsigned char) line[i]);
+    }
+}
+
+// Bytes a word may contain: anything but spaces and control characters
+static bool is_word_byte(unsigned char c) {
+    return c > ' ' && c != 127;
+}
+
+// Alphabet pass: find the symbols used by the words the loader will keep
+// and rebuild the (still empty) dictionary with nodes sized for exactly
+// those. Words with other bytes are left out of the alphabet and skipped.
+static bool analyse_alphabet(FILE* file) {
+    bool used[ALPHABET_MAX] = { false };
+    char line[MAX_LINE_LEN];
+    
+    while (fgets(line, sizeof(line), file)) {
+        normalize_line(line);
+        if (strlen(line) < (size_t) MIN_WORD_LEN) continue;
+        
+        bool valid = true;
+        for (int i = 0; line[i] && valid; i++) {
+            valid = is_word_byte(line[i]);
+        }
+        for (int i = 0; line[i] && valid; i++) {
+            used[(unsigned char) line[i]] = true;
+        }
+    }
+    
+    char symbols[ALPHABET_MAX];
+    int symbol_count = 0;
+    for (int c = 0; c < ALPHABET_MAX; c++) {
+        if (used[c]) {
+            symbols[symbol_count++] = (char) c;
+        }
+    }
+    if (symbol_count == 0) {
+        return true;
+    }
+    
+    // Node fan-out is fixed once a trie exists, so start over
+    dictionary_destroy(dictionary);
+    trie_set_alphabet(symbols, symbol_count);
+    dictionary = dictionary_create();
+    return dictionary != NULL;
+}
+
+// Load dictionary from file. The first load picks the trie alphabet from
+// the words in the file; later loads skip words outside it, and once a
+// search has run they publish their words without disturbing it.
 bool palindrome_load_dictionary(const char* filename) {
-    if (!dictionary_root || !reverse_dictionary_root) {
+    if (!dictionary) {
         return false;
     }
     
@@ -375,56 +1035,196 @@ bool palindrome_load_dictionary(const char* filename) {
         return false;
     }
     
+    if (dictionary->words->count == 0 && !dictionary->shared) {
+        if (!analyse_alphabet(file)) {
+            fclose(file);
+            return false;
+        }
+        rewind(file);
+    }
+    
     char line[MAX_LINE_LEN];
     int words_loaded = 0;
+    int words_skipped = 0;
     
+    // Words loaded while searches are running appear to them all at once
+    dictionary_load_begin(dictionary);
     while (fgets(line, sizeof(line), file)) {
-        // Remove newline and convert to lowercase
-        line[strcspn(line, "\n\r")] = 0;
-        
-        for (int i = 0; line[i]; i++) {
-            line[i] = tolower(line[i]);
-        }
+        normalize_line(line);
         
         if (strlen(line) >= (size_t) MIN_WORD_LEN) {
-            trie_insert(dictionary_root, line);
-            
-            char* reversed = string_reverse(line);
-            if (reversed) {
-                trie_insert(reverse_dictionary_root, reversed);
-                free(reversed);
+            if (!trie_in_alphabet(line)) {
+                words_skipped++;
+            } else if (dictionary_load_word(dictionary, line)) {
+                words_loaded++;
             }
-            
-            words_loaded++;
         }
     }
     
+    bool published = dictionary_load_end(dictionary);
     fclose(file);
+    if (!published) {
+        printf("Error: Failed to publish words from %s\n", filename);
+        return false;
+    }
     printf("Loaded %d words\n", words_loaded);
+    if (words_skipped > 0) {
+        printf("Skipped %d words with unsupported characters\n", words_skipped);
+    }
     return true;
 }
 
-// Main entry point for finding palindromes
-int palindrome_find_all(const char* starting_word) {
-    if (!dictionary_root || !reverse_dictionary_root) {
-        return 0;
+// Normalise a word the way the loader does; false if it is not accepted
+static bool normalize_word(const char* word, char* normalized) {
+    size_t len = strlen(word);
+    if (len >= MAX_WORD_LEN || len < (size_t) MIN_WORD_LEN) {
+        return false;
     }
     
-    // Reset counter
+    for (size_t i = 0; i <= len; i++) {
+        normalized[i] = tolower((unsigned char) word[i]);
+    }
+    return true;
+}
+
+// Add a word to the loaded dictionary without blocking running searches
+bool palindrome_add_word(const char* word) {
+    char normalized[MAX_WORD_LEN];
+    if (!dictionary || !word || !normalize_word(word, normalized)) {
+        return false;
+    }
+    return dictionary_add_word(dictionary, normalized);
+}
+
+// Remove a word from the loaded dictionary without blocking running searches
+bool palindrome_remove_word(const char* word) {
+    char normalized[MAX_WORD_LEN];
+    if (!dictionary || !word || !normalize_word(word, normalized)) {
+        return false;
+    }
+    return dictionary_remove_word(dictionary, normalized);
+}
+
+// Reset counters and pin the dictionary. The starting words are added to a
+// private copy of the pinned tries, so they do not outlive this search.
+static void begin_search(const char** starting_words, int count) {
     palindrome_count = 0;
+    result_queue_reset_stats(result_queue);
+    
+    search_snapshot = dictionary_acquire(dictionary);
+    dictionary_root = search_snapshot->forward;
+    reverse_dictionary_root = search_snapshot->reverse;
+    trie_update_init(&search_update);
     
-    // Add starting word to dictionaries
-    if (strlen(starting_word) >= (size_t) MIN_WORD_LEN) {
-        trie_insert(dictionary_root, starting_word);
+    // Starting words are not interned; they are query words with ids below
+    // -1, which cannot collide with dictionary ids
+    wordlist_reset(query_words);
+    for (int i = 0; i < count; i++) {
+        const char* starting_word = starting_words[i];
+        int word_id = add_query_word(starting_word, strlen(starting_word));
+        if (strlen(starting_word) < (size_t) MIN_WORD_LEN) continue;
+        
+        dictionary_root = trie_insert_cow(dictionary_root, starting_word, word_id, &search_update);
         char* reversed_attempt = string_reverse(starting_word);
         if (reversed_attempt) {
-            trie_insert(reverse_dictionary_root, reversed_attempt);
+            reverse_dictionary_root = trie_insert_cow(reverse_dictionary_root, reversed_attempt,
+                                                      word_id, &search_update);
             free(reversed_attempt);
         }
     }
+}
+
+// Drain output and drop the search's view of the dictionary
+static void end_search(void) {
+    result_queue_flush(result_queue);
+    
+    trie_update_discard(&search_update);
+    dictionary_release(dictionary, search_snapshot);
+    search_snapshot = NULL;
+    dictionary_root = NULL;
+    reverse_dictionary_root = NULL;
+}
+
+// Main entry point for finding palindromes
+int palindrome_find_all(const char* starting_word) {
+    if (!dictionary) {
+        return 0;
+    }
+    
+    begin_search(&starting_word, 1);
         
     // Find palindromes
     find_palindromes(starting_word);
+    end_search();
     
     return palindrome_count;
 }
+
+// Entry point for shortest-first search; on_level (optional) is called after
+// each word count is complete and may return false to stop early
+int palindrome_find_shortest_first(const char* starting_word,
+                                   PalindromeLevelCallback on_level, void* context) {
+    if (!dictionary) {
+        return 0;
+    }
+
+    begin_search(&starting_word, 1);
+    find_palindromes_shortest_first(starting_word, on_level, context);
+    end_search();
+
+    return palindrome_count;
+}
+
+// Entry point for batched queries. Results are tagged with their seed, and
+// counts (optional) receives the number found for each seed. Each seed finds
+// exactly what palindrome_find_all finds for it alone: seeds that are not
+// words join the dictionary only in a version of their own for the duration
+// of the batch. Returns the total over all seeds.
+int palindrome_find_batch(const char** seeds, int seed_count, int* counts) {
+    if (!dictionary || !seeds || seed_count <= 0) {
+        return 0;
+    }
+
+    // Group identical seeds so each distinct seed is searched once
+    BatchSeed* sorted = malloc(sizeof(BatchSeed) * seed_count);
+    const char** group_seeds = malloc(sizeof(char*) * seed_count);
+    int* group_of = malloc(sizeof(int) * seed_count);
+    int* group_counts = calloc(seed_count, sizeof(int));
+    if (!sorted || !group_seeds || !group_of || !group_counts) {
+        free(sorted);
+        free(group_seeds);
+        free(group_of);
+        free(group_counts);
+        return 0;
+    }
+
+    for (int i = 0; i < seed_count; i++) {
+        sorted[i].seed = seeds[i];
+        sorted[i].index = i;
+    }
+    qsort(sorted, seed_count, sizeof(BatchSeed), compare_batch_seeds);
+
+    int group_count = 0;
+    for (int i = 0; i < seed_count; i++) {
+        if (group_count == 0 || strcmp(sorted[i].seed, group_seeds[group_count - 1]) != 0) {
+            group_seeds[group_count++] = sorted[i].seed;
+        }
+        group_of[sorted[i].index] = group_count - 1;
+    }
+
+    begin_search(NULL, 0);
+    find_palindromes_batch(group_seeds, group_count, group_counts);
+    end_search();
+
+    if (counts) {
+        for (int i = 0; i < seed_count; i++) {
+            counts[i] = group_counts[group_of[i]];
+        }
+    }
+
+    free(sorted);
+    free(group_seeds);
+    free(group_of);
+    free(group_counts);
+    return palindrome_count;
+}
@@ -4,37 +4,57 @@
 #include <stdbool.h>
 #include "wordList.h"
 #include "trie.h"
+#include "dictionary.h"
+#include "resultQueue.h"
+#include "searchMemo.h"
+#include "searchState.h"
 
 #define MAX_PALINDROME_LEN 6
 #define MAX_WORD_LEN 100
 #define MAX_LINE_LEN 1000
+#define MAX_TEXT_LEN (MAX_LINE_LEN * 2)   // longest overhang: a compound start of two words
 #define MAX_RESULTS 100000
 #define STACK_SIZE MAX_PALINDROME_LEN * 10000
+#define MEMO_MAX_ENTRIES (1 << 18)
+#define MEMO_MAX_CACHED_WORDS (1 << 20)
 
-// Search state for iterative backtracking
-typedef struct {
-    char* settled;      // accumulated left side
-    char* overhang;       // current unmatched portion
-    int depth;
-    bool is_forwards;     // direction of current search
-} SearchState;
+#if MAX_PALINDROME_LEN + 1 > SEARCH_PATH_MAX
+#error "SEARCH_PATH_MAX must leave room for MAX_PALINDROME_LEN + 1 pieces"
+#endif
+
+// Called after each word count finishes in shortest-first mode with the
+// number of palindromes of that length; return false to stop the search
+typedef bool (*PalindromeLevelCallback)(int word_count, int found, void* context);
 
 // Core palindrome finder functions
 bool palindrome_init(void);
 void palindrome_cleanup(void);
 bool palindrome_load_dictionary(const char* filename);
+bool palindrome_add_word(const char* word);
+bool palindrome_remove_word(const char* word);
 bool palindrome_set_output_file(const char* filename);
 void palindrome_set_min_word_length(int min_len);
+void palindrome_set_max_depth(int depth);
+void palindrome_set_closing_lists(bool enabled);
+void palindrome_set_echo(bool echo);
+void palindrome_set_output_policy(ResultQueuePolicy policy);
+void palindrome_print_output_stats(void);
 int palindrome_find_all(const char* starting_word);
+int palindrome_find_shortest_first(const char* starting_word,
+                                   PalindromeLevelCallback on_level, void* context);
+int palindrome_find_batch(const char** seeds, int seed_count, int* counts);
 
 // Utility functions
 char* string_reverse(const char* str);
 bool is_palindrome(const char* str);
 void get_prefixes(const char* word, WordList* result);
-void generate_candidates(const char* prefix, bool is_forwards, WordList* candidates);
+void generate_candidates(const char* prefix, bool is_forwards, IdList* candidates);
 
 // Internal search functions
 bool find_palindromes(const char* starting_prefix);
-void output_palindrome(const char* settled, const char* middle, bool was_forward);
+bool find_palindromes_shortest_first(const char* starting_prefix,
+                                     PalindromeLevelCallback on_level, void* context);
+bool find_palindromes_batch(const char** group_seeds, int group_count, int* group_counts);
+void output_palindrome(const SearchState* state);
 
 #endif // CPALINDROMER_H
\ No newline at end of file
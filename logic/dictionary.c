@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "dictionary.h"
+
+static DictionarySnapshot* snapshot_create(TrieNode* forward, TrieNode* reverse, long version) {
+    DictionarySnapshot* snapshot = malloc(sizeof(DictionarySnapshot));
+    if (!snapshot) return NULL;
+
+    snapshot->forward = forward;
+    snapshot->reverse = reverse;
+    snapshot->version = version;
+    snapshot->refcount = 0;
+    snapshot->retired = (TrieNodeList) { NULL, 0, 0 };
+    snapshot->next = NULL;
+    return snapshot;
+}
+
+static char* reverse_word(const char* word) {
+    int len = strlen(word);
+    char* reversed = malloc(len + 1);
+    if (!reversed) return NULL;
+
+    for (int i = 0; i < len; i++) {
+        reversed[i] = word[len - 1 - i];
+    }
+    reversed[len] = '\0';
+    return reversed;
+}
+
+// Free unpinned old snapshots, oldest first. Nodes retired by a snapshot
+// are still reachable from older ones, so stop at the first pinned one.
+// Caller holds dictionary->lock.
+static void reclaim_snapshots(Dictionary* dictionary) {
+    while (dictionary->oldest != dictionary->current && dictionary->oldest->refcount == 0) {
+        DictionarySnapshot* snapshot = dictionary->oldest;
+        dictionary->oldest = snapshot->next;
+        trie_node_list_free(&snapshot->retired, true);
+        free(snapshot);
+    }
+}
+
+// Make the update's version current; takes over the update's node lists
+static bool publish(Dictionary* dictionary, TrieNode* forward, TrieNode* reverse,
+                    TrieUpdate* update) {
+    DictionarySnapshot* base = dictionary->current;
+    DictionarySnapshot* snapshot = snapshot_create(forward, reverse, base->version + 1);
+    if (!snapshot) {
+        trie_update_discard(update);
+        return false;
+    }
+
+    pthread_mutex_lock(&dictionary->lock);
+    base->retired = update->replaced;
+    base->next = snapshot;
+    dictionary->current = snapshot;
+    dictionary->shared = true;
+    reclaim_snapshots(dictionary);
+    pthread_mutex_unlock(&dictionary->lock);
+
+    trie_node_list_free(&update->created, false);
+    return true;
+}
+
+Dictionary* dictionary_create(void) {
+    Dictionary* dictionary = malloc(sizeof(Dictionary));
+    if (!dictionary) return NULL;
+
+    TrieNode* forward = trie_create();
+    TrieNode* reverse = trie_create();
+    dictionary->words = word_table_create();
+    dictionary->current = snapshot_create(forward, reverse, 0);
+    if (!dictionary->words || !dictionary->current) {
+        trie_destroy(forward);
+        trie_destroy(reverse);
+        word_table_destroy(dictionary->words);
+        free(dictionary->current);
+        free(dictionary);
+        return NULL;
+    }
+    dictionary->oldest = dictionary->current;
+    dictionary->shared = false;
+    dictionary->load_pending = false;
+
+    pthread_mutex_init(&dictionary->lock, NULL);
+    pthread_mutex_init(&dictionary->write_lock, NULL);
+    return dictionary;
+}
+
+// Destroy the dictionary; no snapshot may still be pinned
+void dictionary_destroy(Dictionary* dictionary) {
+    if (!dictionary) return;
+
+    DictionarySnapshot* snapshot = dictionary->oldest;
+    while (snapshot) {
+        DictionarySnapshot* next = snapshot->next;
+        if (snapshot == dictionary->current) {
+            trie_destroy(snapshot->forward);
+            trie_destroy(snapshot->reverse);
+        } else {
+            trie_node_list_free(&snapshot->retired, true);
+        }
+        free(snapshot);
+        snapshot = next;
+    }
+
+    word_table_destroy(dictionary->words);
+    pthread_mutex_destroy(&dictionary->lock);
+    pthread_mutex_destroy(&dictionary->write_lock);
+    free(dictionary);
+}
+
+// Pin the current snapshot
+DictionarySnapshot* dictionary_acquire(Dictionary* dictionary) {
+    pthread_mutex_lock(&dictionary->lock);
+    DictionarySnapshot* snapshot = dictionary->current;
+    snapshot->refcount++;
+    dictionary->shared = true;
+    pthread_mutex_unlock(&dictionary->lock);
+    return snapshot;
+}
+
+void dictionary_release(Dictionary* dictionary, DictionarySnapshot* snapshot) {
+    if (!snapshot) return;
+
+    pthread_mutex_lock(&dictionary->lock);
+    snapshot->refcount--;
+    reclaim_snapshots(dictionary);
+    pthread_mutex_unlock(&dictionary->lock);
+}
+
+// Id for a word, reusing the entry of a word that was removed and comes
+// back. Caller holds write_lock.
+static int intern_word(Dictionary* dictionary, const char* word) {
+    int length = strlen(word);
+    int id = word_table_find(dictionary->words, word, length);
+    if (id < 0) {
+        id = word_table_add(dictionary->words, word, length);
+    }
+    return id;
+}
+
+// Add a word as a new published version. Caller holds write_lock.
+static bool add_word_locked(Dictionary* dictionary, const char* word, const char* reversed) {
+    DictionarySnapshot* base = dictionary->current;
+    if (trie_search(base->forward, word)) return false;
+
+    int id = intern_word(dictionary, word);
+    if (id < 0) return false;
+
+    TrieUpdate update;
+    trie_update_init(&update);
+    TrieNode* forward = trie_insert_cow(base->forward, word, id, &update);
+    TrieNode* reverse = trie_insert_cow(base->reverse, reversed, id, &update);
+
+    bool changed = forward != base->forward || reverse != base->reverse;
+    if (changed) {
+        changed = publish(dictionary, forward, reverse, &update);
+    } else {
+        trie_update_free(&update);
+    }
+    return changed;
+}
+
+void dictionary_load_begin(Dictionary* dictionary) {
+    pthread_mutex_lock(&dictionary->write_lock);
+}
+
+// Until a snapshot has been handed out or published, nothing else can see
+// the current tries, so words go straight into them. After that the same
+// nodes may be shared with older versions and searches, so the rest of the
+// load goes into a path-copied version of its own. Its nodes are private
+// until load_end publishes it, so they are modified in place.
+bool dictionary_load_word(Dictionary* dictionary, const char* word) {
+    if (!trie_in_alphabet(word)) return false;
+
+    char* reversed = reverse_word(word);
+    if (!reversed) return false;
+
+    pthread_mutex_lock(&dictionary->lock);
+    bool loaded;
+
+    if (dictionary->shared) {
+        pthread_mutex_unlock(&dictionary->lock);
+        if (!dictionary->load_pending) {
+            trie_update_init(&dictionary->load_update);
+            dictionary->load_forward = dictionary->current->forward;
+            dictionary->load_reverse = dictionary->current->reverse;
+            dictionary->load_pending = true;
+        }
+
+        int id = -1;
+        if (!trie_search(dictionary->load_forward, word)) {
+            id = intern_word(dictionary, word);
+        }
+        if (id >= 0) {
+            dictionary->load_forward = trie_insert_cow(dictionary->load_forward, word, id,
+                                                       &dictionary->load_update);
+            dictionary->load_reverse = trie_insert_cow(dictionary->load_reverse, reversed, id,
+                                                       &dictionary->load_update);
+        }
+        loaded = id >= 0;
+    } else {
+        DictionarySnapshot* current = dictionary->current;
+        int id = -1;
+        if (!trie_search(current->forward, word)) {
+            id = intern_word(dictionary, word);
+        }
+        if (id >= 0) {
+            trie_insert(current->forward, word, id);
+            trie_insert(current->reverse, reversed, id);
+        }
+        loaded = id >= 0;
+        pthread_mutex_unlock(&dictionary->lock);
+    }
+
+    free(reversed);
+    return loaded;
+}
+
+// Publish what the load collected as a single version
+bool dictionary_load_end(Dictionary* dictionary) {
+    bool published = true;
+
+    if (dictionary->load_pending) {
+        DictionarySnapshot* base = dictionary->current;
+        if (dictionary->load_forward != base->forward || dictionary->load_reverse != base->reverse) {
+            published = publish(dictionary, dictionary->load_forward, dictionary->load_reverse,
+                                &dictionary->load_update);
+        } else {
+            trie_update_free(&dictionary->load_update);
+        }
+        dictionary->load_pending = false;
+    }
+
+    pthread_mutex_unlock(&dictionary->write_lock);
+    return published;
+}
+
+bool dictionary_add_word(Dictionary* dictionary, const char* word) {
+    if (!trie_in_alphabet(word)) return false;
+
+    char* reversed = reverse_word(word);
+    if (!reversed) return false;
+
+    pthread_mutex_lock(&dictionary->write_lock);
+    bool added = add_word_locked(dictionary, word, reversed);
+    pthread_mutex_unlock(&dictionary->write_lock);
+
+    free(reversed);
+    return added;
+}
+
+bool dictionary_remove_word(Dictionary* dictionary, const char* word) {
+    char* reversed = reverse_word(word);
+    if (!reversed) return false;
+
+    pthread_mutex_lock(&dictionary->write_lock);
+    DictionarySnapshot* base = dictionary->current;
+
+    TrieUpdate update;
+    trie_update_init(&update);
+    TrieNode* forward = trie_remove_cow(base->forward, word, &update);
+    TrieNode* reverse = trie_remove_cow(base->reverse, reversed, &update);
+
+    bool changed = forward != base->forward || reverse != base->reverse;
+    if (changed) {
+        changed = publish(dictionary, forward, reverse, &update);
+    } else {
+        trie_update_free(&update);
+    }
+
+    pthread_mutex_unlock(&dictionary->write_lock);
+    free(reversed);
+    return changed;
+}
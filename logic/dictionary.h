@@ -0,0 +1,61 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "trie.h"
+#include "wordTable.h"
+
+// Immutable view of the forward and reverse tries. Searches pin one with
+// dictionary_acquire and see the same words until they release it.
+typedef struct DictionarySnapshot {
+    TrieNode* forward;
+    TrieNode* reverse;
+    long version;
+    int refcount;
+    TrieNodeList retired;               // nodes the next version replaced
+    struct DictionarySnapshot* next;    // next newer snapshot
+} DictionarySnapshot;
+
+// Word list shared by searches and updaters. Updates build a new version by
+// path copying and publish it; old versions are freed once unpinned. Each
+// word is interned once in the word table and both tries store its id.
+typedef struct {
+    WordTable* words;
+    DictionarySnapshot* current;
+    DictionarySnapshot* oldest;
+    pthread_mutex_t lock;           // guards current, refcounts and the snapshot list
+    pthread_mutex_t write_lock;     // serialises updates
+    bool shared;                    // a snapshot has been acquired or published
+
+    // Unpublished version built by a load once the tries are shared
+    bool load_pending;
+    TrieUpdate load_update;
+    TrieNode* load_forward;
+    TrieNode* load_reverse;
+} Dictionary;
+
+Dictionary* dictionary_create(void);
+void dictionary_destroy(Dictionary* dictionary);
+
+// Readers
+DictionarySnapshot* dictionary_acquire(Dictionary* dictionary);
+void dictionary_release(Dictionary* dictionary, DictionarySnapshot* snapshot);
+
+// Bulk loading: load_word calls go between load_begin and load_end, which
+// hold off other updates. Words go into the current version in place while
+// no snapshot has been acquired or published; after that they are collected
+// into one new version that load_end publishes. load_word returns false for
+// duplicates and for words with a character outside the trie alphabet.
+void dictionary_load_begin(Dictionary* dictionary);
+bool dictionary_load_word(Dictionary* dictionary, const char* word);
+bool dictionary_load_end(Dictionary* dictionary);
+
+// Live updates; each publishes a new snapshot and returns false if the
+// word was already present or not in the alphabet (add) or absent (remove). Removed words keep
+// their table entry, since searches may still hold their id, and get the
+// same id back if they are added again.
+bool dictionary_add_word(Dictionary* dictionary, const char* word);
+bool dictionary_remove_word(Dictionary* dictionary, const char* word);
+
+#endif // DICTIONARY_H
@@ -0,0 +1,539 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "resultQueue.h"
+
+#define RESULT_LINE_LEN (RESULT_TEXT_LEN * 2 + RESULT_TAG_LEN + 16)
+#define WRITER_IDLE_WAIT_NS 2000000L          // idle this long and the pending batch is written
+#define WRITER_MAX_BATCH_AGE_NS 50000000LL    // oldest line a busy writer may hold back
+#define PRODUCER_BLOCK_WAIT_NS 1000000L       // longest a blocked producer sleeps before retrying
+
+// One ring slot; sequence follows the bounded MPMC scheme (Vyukov):
+// sequence == position means free, position + 1 means holding a result
+typedef struct {
+    size_t sequence;
+    long long enqueued_ns;
+    PalindromeResult result;
+} ResultSlot;
+
+// Overflow node for RESULT_POLICY_SPILL
+typedef struct SpillNode {
+    long long enqueued_ns;
+    PalindromeResult result;
+    struct SpillNode* next;
+} SpillNode;
+
+struct ResultQueue {
+    ResultSlot* slots;
+    size_t mask;
+    size_t tail;                // next position claimed by producers
+    size_t head;                // next position read by the writer
+
+    ResultQueuePolicy policy;
+    ResultFormatter formatter;
+    FILE* sink;
+    bool echo;
+
+    // Spill list (only touched when the ring is full)
+    pthread_mutex_t spill_lock;
+    SpillNode* spill_head;
+    SpillNode* spill_tail;
+
+    // Writer thread and its wakeup; blocked producers wait on space
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t space;
+    int space_waiters;
+    int writer_idle;
+    int flush_requested;
+    int stopping;
+
+    // Statistics
+    long published;
+    long written;
+    long dropped;
+    long spilled;
+    long blocked;
+    long batches;
+    long max_depth;
+    long long depth_sum;
+    long long latency_sum_ns;
+    long long latency_max_ns;
+};
+
+// Batch buffers owned by the writer thread
+typedef struct {
+    char* text;
+    size_t used;
+    char* echo;
+    size_t echo_used;
+    size_t capacity;
+    long count;
+    long long first_ns;     // when the batch's first line was added
+    long long* enqueued_ns; // publish time of each line, for write latency
+} WriterBatch;
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Absolute CLOCK_REALTIME time wait_ns from now, for pthread_cond_timedwait
+static void deadline_after(long wait_ns, struct timespec* deadline) {
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_nsec += wait_ns;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+static void atomic_max(long long* target, long long value) {
+    long long current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > current &&
+           !__atomic_compare_exchange_n(target, &current, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Wake the writer if it is idle. The idle flag, the slot sequences and the
+// spill head are all sequentially consistent: the producer stores its slot
+// then loads the flag, the writer stores the flag then loads the slot, and
+// only a total order guarantees one of them sees the other.
+static void wake_writer(ResultQueue* queue) {
+    if (__atomic_load_n(&queue->writer_idle, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&queue->lock);
+        pthread_cond_signal(&queue->wake);
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+static void record_depth(ResultQueue* queue) {
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    long depth = (long) (tail - head);
+    if (depth < 0) depth = 0;
+
+    __atomic_fetch_add(&queue->depth_sum, depth, __ATOMIC_RELAXED);
+    long current = __atomic_load_n(&queue->max_depth, __ATOMIC_RELAXED);
+    while (depth > current &&
+           !__atomic_compare_exchange_n(&queue->max_depth, &current, depth, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Whether the next slot producers would claim is free
+static bool ring_has_space(ResultQueue* queue) {
+    size_t pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    size_t seq = __atomic_load_n(&queue->slots[pos & queue->mask].sequence, __ATOMIC_SEQ_CST);
+    return (long) seq - (long) pos >= 0;
+}
+
+// Sleep until the writer frees a slot (or a short timeout passes). The
+// waiter count and the slot sequences are sequentially consistent, so either
+// the writer sees this producer waiting or the producer sees the free slot.
+static void wait_for_space(ResultQueue* queue) {
+    wake_writer(queue);
+
+    pthread_mutex_lock(&queue->lock);
+    __atomic_add_fetch(&queue->space_waiters, 1, __ATOMIC_SEQ_CST);
+    if (!ring_has_space(queue)) {
+        struct timespec deadline;
+        deadline_after(PRODUCER_BLOCK_WAIT_NS, &deadline);
+        pthread_cond_timedwait(&queue->space, &queue->lock, &deadline);
+    }
+    __atomic_sub_fetch(&queue->space_waiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Claim a slot and copy the result in; false when the ring is full
+static bool ring_try_push(ResultQueue* queue, const PalindromeResult* result) {
+    size_t pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+    for (;;) {
+        ResultSlot* slot = &queue->slots[pos & queue->mask];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long) seq - (long) pos;
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->result = *result;
+                slot->enqueued_ns = now_ns();
+                __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_SEQ_CST);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void spill_push(ResultQueue* queue, const PalindromeResult* result) {
+    SpillNode* node = malloc(sizeof(SpillNode));
+    if (!node) {
+        fprintf(stderr, "Memory allocation failed for spilled result\n");
+        exit(1);
+    }
+    node->result = *result;
+    node->enqueued_ns = now_ns();
+    node->next = NULL;
+
+    pthread_mutex_lock(&queue->spill_lock);
+    if (queue->spill_tail) {
+        queue->spill_tail->next = node;
+    } else {
+        __atomic_store_n(&queue->spill_head, node, __ATOMIC_SEQ_CST);
+    }
+    queue->spill_tail = node;
+    pthread_mutex_unlock(&queue->spill_lock);
+}
+
+bool result_queue_publish(ResultQueue* queue, const PalindromeResult* result) {
+    if (!queue || !result) return false;
+
+    record_depth(queue);
+
+    if (!ring_try_push(queue, result)) {
+        switch (queue->policy) {
+            case RESULT_POLICY_DROP:
+                __atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+                return false;
+
+            case RESULT_POLICY_SPILL:
+                spill_push(queue, result);
+                __atomic_fetch_add(&queue->spilled, 1, __ATOMIC_RELAXED);
+                break;
+
+            case RESULT_POLICY_BLOCK:
+            default:
+                __atomic_fetch_add(&queue->blocked, 1, __ATOMIC_RELAXED);
+                do {
+                    wait_for_space(queue);
+                } while (!ring_try_push(queue, result));
+                break;
+        }
+    }
+
+    __atomic_fetch_add(&queue->published, 1, __ATOMIC_RELEASE);
+    wake_writer(queue);
+    return true;
+}
+
+// Write the pending batch to the sink (and stdout when echoing)
+static void batch_flush(ResultQueue* queue, WriterBatch* batch) {
+    if (batch->count == 0) return;
+
+    pthread_mutex_lock(&queue->lock);
+    FILE* sink = queue->sink;
+    bool echo = queue->echo;
+    pthread_mutex_unlock(&queue->lock);
+
+    if (sink) {
+        fwrite(batch->text, 1, batch->used, sink);
+        fflush(sink);
+    }
+    if (echo) {
+        fwrite(batch->echo, 1, batch->echo_used, stdout);
+        fflush(stdout);
+    }
+
+    // Latency runs until the line is out, including any time spent held back
+    long long written_ns = now_ns();
+    long long latency_sum = 0;
+    long long latency_max = 0;
+    for (long i = 0; i < batch->count; i++) {
+        long long latency = written_ns - batch->enqueued_ns[i];
+        latency_sum += latency;
+        if (latency > latency_max) latency_max = latency;
+    }
+    __atomic_fetch_add(&queue->latency_sum_ns, latency_sum, __ATOMIC_RELAXED);
+    atomic_max(&queue->latency_max_ns, latency_max);
+
+    __atomic_fetch_add(&queue->batches, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&queue->written, batch->count, __ATOMIC_RELEASE);
+    batch->used = 0;
+    batch->echo_used = 0;
+    batch->count = 0;
+}
+
+// Format one result into the batch, flushing first if it is full
+static void batch_add(ResultQueue* queue, WriterBatch* batch,
+                      const PalindromeResult* result, long long enqueued_ns) {
+    if (batch->count >= RESULT_BATCH_SIZE ||
+        batch->used + RESULT_LINE_LEN > batch->capacity ||
+        batch->echo_used + RESULT_LINE_LEN + 8 > batch->capacity) {
+        batch_flush(queue, batch);
+    }
+
+    if (batch->count == 0) {
+        batch->first_ns = now_ns();
+    }
+
+    char* line = batch->text + batch->used;
+    int len = queue->formatter(result, line, RESULT_LINE_LEN - 1);
+    if (len < 0) len = 0;
+    if (len > RESULT_LINE_LEN - 2) len = RESULT_LINE_LEN - 2;
+
+    memcpy(batch->echo + batch->echo_used, "Found: ", 7);
+    memcpy(batch->echo + batch->echo_used + 7, line, len);
+    batch->echo_used += 7 + len;
+    batch->echo[batch->echo_used++] = '\n';
+
+    line[len] = '\n';
+    batch->used += len + 1;
+    batch->enqueued_ns[batch->count++] = enqueued_ns;
+}
+
+// Let producers blocked on a full ring retry after the writer freed slots
+static void release_producers(ResultQueue* queue) {
+    if (__atomic_load_n(&queue->space_waiters, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&queue->lock);
+        pthread_cond_broadcast(&queue->space);
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+// Move everything currently available into the batch; returns items taken
+static long writer_drain(ResultQueue* queue, WriterBatch* batch) {
+    long taken = 0;
+
+    for (;;) {
+        size_t head = queue->head;
+        ResultSlot* slot = &queue->slots[head & queue->mask];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (seq != head + 1) break;
+
+        batch_add(queue, batch, &slot->result, slot->enqueued_ns);
+        __atomic_store_n(&slot->sequence, head + queue->mask + 1, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELAXED);
+        taken++;
+
+        // Freed slots are usable while the full batch is being written
+        if (batch->count >= RESULT_BATCH_SIZE) {
+            release_producers(queue);
+            batch_flush(queue, batch);
+        }
+    }
+    if (taken > 0) {
+        release_producers(queue);
+    }
+
+    if (__atomic_load_n(&queue->spill_head, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&queue->spill_lock);
+        SpillNode* node = queue->spill_head;
+        __atomic_store_n(&queue->spill_head, NULL, __ATOMIC_RELAXED);
+        queue->spill_tail = NULL;
+        pthread_mutex_unlock(&queue->spill_lock);
+
+        while (node) {
+            SpillNode* next = node->next;
+            batch_add(queue, batch, &node->result, node->enqueued_ns);
+            free(node);
+            node = next;
+            taken++;
+        }
+    }
+
+    // Keep filling a partial batch unless its oldest line has waited too long
+    if (batch->count > 0 && now_ns() - batch->first_ns >= WRITER_MAX_BATCH_AGE_NS) {
+        batch_flush(queue, batch);
+    }
+    return taken;
+}
+
+static bool writer_has_work(ResultQueue* queue) {
+    ResultSlot* slot = &queue->slots[queue->head & queue->mask];
+    return __atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) == queue->head + 1 ||
+           __atomic_load_n(&queue->spill_head, __ATOMIC_SEQ_CST) != NULL;
+}
+
+static void* writer_main(void* arg) {
+    ResultQueue* queue = arg;
+
+    WriterBatch batch;
+    batch.capacity = (size_t) RESULT_LINE_LEN * (RESULT_BATCH_SIZE + 1);
+    batch.text = malloc(batch.capacity);
+    batch.echo = malloc(batch.capacity);
+    batch.used = 0;
+    batch.echo_used = 0;
+    batch.count = 0;
+    batch.first_ns = 0;
+    batch.enqueued_ns = malloc(sizeof(long long) * RESULT_BATCH_SIZE);
+    if (!batch.text || !batch.echo || !batch.enqueued_ns) {
+        fprintf(stderr, "Memory allocation failed for writer batch\n");
+        exit(1);
+    }
+
+    // Partial batches are written when someone flushes, when the writer
+    // has been idle for a full wait, or when they get too old
+    for (;;) {
+        if (writer_drain(queue, &batch) > 0) continue;
+
+        if (__atomic_exchange_n(&queue->flush_requested, 0, __ATOMIC_SEQ_CST)) {
+            batch_flush(queue, &batch);
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        __atomic_store_n(&queue->writer_idle, 1, __ATOMIC_SEQ_CST);
+        bool idle = !writer_has_work(queue);
+        if (idle) {
+            if (queue->stopping) {
+                pthread_mutex_unlock(&queue->lock);
+                break;
+            }
+            struct timespec deadline;
+            deadline_after(WRITER_IDLE_WAIT_NS, &deadline);
+            pthread_cond_timedwait(&queue->wake, &queue->lock, &deadline);
+            idle = !writer_has_work(queue);
+        }
+        __atomic_store_n(&queue->writer_idle, 0, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&queue->lock);
+
+        if (idle) {
+            batch_flush(queue, &batch);
+        }
+    }
+
+    batch_flush(queue, &batch);
+    free(batch.text);
+    free(batch.echo);
+    free(batch.enqueued_ns);
+    return NULL;
+}
+
+ResultQueue* result_queue_create(ResultQueuePolicy policy, ResultFormatter formatter) {
+    if (!formatter) return NULL;
+
+    ResultQueue* queue = calloc(1, sizeof(ResultQueue));
+    if (!queue) return NULL;
+
+    queue->slots = malloc(sizeof(ResultSlot) * RESULT_QUEUE_CAPACITY);
+    if (!queue->slots) {
+        free(queue);
+        return NULL;
+    }
+    for (size_t i = 0; i < RESULT_QUEUE_CAPACITY; i++) {
+        queue->slots[i].sequence = i;
+    }
+    queue->mask = RESULT_QUEUE_CAPACITY - 1;
+    queue->policy = policy;
+    queue->formatter = formatter;
+    queue->echo = true;
+
+    pthread_mutex_init(&queue->spill_lock, NULL);
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->wake, NULL);
+    pthread_cond_init(&queue->space, NULL);
+
+    if (pthread_create(&queue->writer, NULL, writer_main, queue) != 0) {
+        pthread_cond_destroy(&queue->space);
+        pthread_cond_destroy(&queue->wake);
+        pthread_mutex_destroy(&queue->lock);
+        pthread_mutex_destroy(&queue->spill_lock);
+        free(queue->slots);
+        free(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+void result_queue_destroy(ResultQueue* queue) {
+    if (!queue) return;
+
+    pthread_mutex_lock(&queue->lock);
+    queue->stopping = 1;
+    pthread_cond_signal(&queue->wake);
+    pthread_mutex_unlock(&queue->lock);
+    pthread_join(queue->writer, NULL);
+
+    pthread_cond_destroy(&queue->space);
+    pthread_cond_destroy(&queue->wake);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_mutex_destroy(&queue->spill_lock);
+    free(queue->slots);
+    free(queue);
+}
+
+void result_queue_flush(ResultQueue* queue) {
+    if (!queue) return;
+
+    struct timespec pause = { 0, 50000 };
+    while (__atomic_load_n(&queue->written, __ATOMIC_ACQUIRE) <
+           __atomic_load_n(&queue->published, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&queue->flush_requested, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_lock(&queue->lock);
+        pthread_cond_signal(&queue->wake);
+        pthread_mutex_unlock(&queue->lock);
+        nanosleep(&pause, NULL);
+    }
+}
+
+void result_queue_set_sink(ResultQueue* queue, FILE* sink) {
+    if (!queue) return;
+
+    result_queue_flush(queue);
+    pthread_mutex_lock(&queue->lock);
+    queue->sink = sink;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void result_queue_set_policy(ResultQueue* queue, ResultQueuePolicy policy) {
+    if (!queue) return;
+    queue->policy = policy;
+}
+
+void result_queue_set_echo(ResultQueue* queue, bool echo) {
+    if (!queue) return;
+
+    pthread_mutex_lock(&queue->lock);
+    queue->echo = echo;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void result_queue_get_stats(ResultQueue* queue, ResultQueueStats* stats) {
+    if (!queue || !stats) return;
+
+    stats->published = __atomic_load_n(&queue->published, __ATOMIC_ACQUIRE);
+    stats->written = __atomic_load_n(&queue->written, __ATOMIC_ACQUIRE);
+    stats->dropped = __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+    stats->spilled = __atomic_load_n(&queue->spilled, __ATOMIC_RELAXED);
+    stats->blocked = __atomic_load_n(&queue->blocked, __ATOMIC_RELAXED);
+    stats->batches = __atomic_load_n(&queue->batches, __ATOMIC_RELAXED);
+    stats->max_depth = __atomic_load_n(&queue->max_depth, __ATOMIC_RELAXED);
+
+    long samples = stats->published + stats->dropped;
+    long long depth_sum = __atomic_load_n(&queue->depth_sum, __ATOMIC_RELAXED);
+    stats->avg_depth = samples > 0 ? (double) depth_sum / samples : 0.0;
+
+    long long latency_sum = __atomic_load_n(&queue->latency_sum_ns, __ATOMIC_RELAXED);
+    long long latency_max = __atomic_load_n(&queue->latency_max_ns, __ATOMIC_RELAXED);
+    stats->avg_latency_us = stats->written > 0 ? latency_sum / 1000.0 / stats->written : 0.0;
+    stats->max_latency_us = latency_max / 1000.0;
+}
+
+void result_queue_reset_stats(ResultQueue* queue) {
+    if (!queue) return;
+
+    result_queue_flush(queue);
+    __atomic_store_n(&queue->published, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->written, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->dropped, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->spilled, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->blocked, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->batches, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->max_depth, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->depth_sum, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->latency_sum_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->latency_max_ns, 0, __ATOMIC_RELAXED);
+}
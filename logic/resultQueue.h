@@ -0,0 +1,66 @@
+#ifndef RESULTQUEUE_H
+#define RESULTQUEUE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "searchState.h"
+
+#define RESULT_TEXT_LEN 1600         // longest rendered half of a palindrome
+#define RESULT_TAG_LEN 100
+#define RESULT_QUEUE_CAPACITY 4096   // must be a power of two
+#define RESULT_BATCH_SIZE 256
+
+// What a producer does when the ring is full
+typedef enum {
+    RESULT_POLICY_BLOCK,    // wait for the writer to free a slot
+    RESULT_POLICY_DROP,     // discard the result and count it
+    RESULT_POLICY_SPILL     // park the result on an unbounded overflow list
+} ResultQueuePolicy;
+
+// Raw, unformatted search result as published by a search thread. The
+// state's text and the tag are only referenced, so whatever they point at
+// must stay valid until the result is written (see result_queue_flush).
+typedef struct {
+    SearchState state;      // state whose overhang completed the palindrome
+    const char* tag;        // seed a batch result belongs to, NULL if untagged
+} PalindromeResult;
+
+// Turns a raw result into its printable text; runs on the writer thread.
+// Returns the number of characters written to out (excluding the NUL).
+typedef int (*ResultFormatter)(const PalindromeResult* result, char* out, int out_size);
+
+typedef struct {
+    long published;         // results accepted into the ring or spill list
+    long written;           // results formatted and written by the writer
+    long dropped;           // results discarded under RESULT_POLICY_DROP
+    long spilled;           // results parked on the overflow list
+    long blocked;           // producer waits under RESULT_POLICY_BLOCK
+    long batches;           // writer batches flushed to the sink
+    long max_depth;         // deepest queue depth seen by a producer
+    double avg_depth;       // mean queue depth seen by producers
+    double avg_latency_us;  // mean publish-to-write latency
+    double max_latency_us;  // worst publish-to-write latency
+} ResultQueueStats;
+
+typedef struct ResultQueue ResultQueue;
+
+// Lifecycle: create starts the writer thread, destroy drains and joins it
+ResultQueue* result_queue_create(ResultQueuePolicy policy, ResultFormatter formatter);
+void result_queue_destroy(ResultQueue* queue);
+
+// Configuration (call while no producer is publishing)
+void result_queue_set_sink(ResultQueue* queue, FILE* sink);
+void result_queue_set_policy(ResultQueue* queue, ResultQueuePolicy policy);
+void result_queue_set_echo(ResultQueue* queue, bool echo);
+
+// Producer side (safe from any number of threads)
+bool result_queue_publish(ResultQueue* queue, const PalindromeResult* result);
+
+// Wait until everything published so far has been written
+void result_queue_flush(ResultQueue* queue);
+
+void result_queue_get_stats(ResultQueue* queue, ResultQueueStats* stats);
+void result_queue_reset_stats(ResultQueue* queue);
+
+#endif // RESULTQUEUE_H
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "searchMemo.h"
+
+// FNV-1a over the direction byte and the overhang
+static unsigned int memo_hash(const char* overhang, char direction) {
+    unsigned int hash = 2166136261u;
+    hash = (hash ^ (unsigned char) direction) * 16777619u;
+    for (const char* p = overhang; *p; p++) {
+        hash = (hash ^ (unsigned char) *p) * 16777619u;
+    }
+    return hash;
+}
+
+// Find the entry for a key, or the empty slot where it would go
+static MemoEntry* memo_find(SearchMemo* memo, const char* overhang, bool is_forwards) {
+    char direction = is_forwards ? 'f' : 'b';
+    unsigned int mask = memo->capacity - 1;
+    unsigned int index = memo_hash(overhang, direction) & mask;
+
+    for (;;) {
+        MemoEntry* entry = &memo->entries[index];
+        if (!entry->key) return entry;
+        if (entry->key[0] == direction && strcmp(entry->key + 1, overhang) == 0) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+// Double the table and rehash every entry; false if out of memory
+static bool memo_grow(SearchMemo* memo) {
+    MemoEntry* old_entries = memo->entries;
+    int old_capacity = memo->capacity;
+
+    MemoEntry* entries = calloc(old_capacity * 2, sizeof(MemoEntry));
+    if (!entries) return false;
+    memo->entries = entries;
+    memo->capacity = old_capacity * 2;
+
+    for (int i = 0; i < old_capacity; i++) {
+        MemoEntry* entry = &old_entries[i];
+        if (entry->key) {
+            *memo_find(memo, entry->key + 1, entry->key[0] == 'f') = *entry;
+        }
+    }
+    free(old_entries);
+    return true;
+}
+
+// Find or create an entry; NULL when the table is at its bound
+static MemoEntry* memo_upsert(SearchMemo* memo, const char* overhang, bool is_forwards) {
+    MemoEntry* entry = memo_find(memo, overhang, is_forwards);
+    if (entry->key) return entry;
+    if (memo->count >= memo->max_entries) return NULL;
+
+    // Keep the load factor at or below one half
+    if ((memo->count + 1) * 2 > memo->capacity) {
+        if (!memo_grow(memo)) return NULL;
+        entry = memo_find(memo, overhang, is_forwards);
+    }
+
+    size_t len = strlen(overhang);
+    entry->key = malloc(len + 2);
+    if (!entry->key) return NULL;
+    entry->key[0] = is_forwards ? 'f' : 'b';
+    memcpy(entry->key + 1, overhang, len + 1);
+    entry->dead_budget = -1;
+    entry->candidates = NULL;
+    memo->count++;
+    return entry;
+}
+
+SearchMemo* search_memo_create(int max_entries, long max_cached_words) {
+    SearchMemo* memo = malloc(sizeof(SearchMemo));
+    if (!memo) return NULL;
+
+    // Start small and grow as entries arrive, so short searches stay cheap
+    int capacity = MEMO_INITIAL_CAPACITY;
+
+    memo->entries = calloc(capacity, sizeof(MemoEntry));
+    if (!memo->entries) {
+        free(memo);
+        return NULL;
+    }
+    memo->capacity = capacity;
+    memo->count = 0;
+    memo->max_entries = max_entries;
+    memo->cached_words = 0;
+    memo->max_cached_words = max_cached_words;
+    memo->dead_hits = 0;
+    memo->candidate_hits = 0;
+    return memo;
+}
+
+void search_memo_destroy(SearchMemo* memo) {
+    if (!memo) return;
+
+    for (int i = 0; i < memo->capacity; i++) {
+        MemoEntry* entry = &memo->entries[i];
+        if (entry->key) {
+            free(entry->key);
+            if (entry->candidates) {
+                idlist_free(entry->candidates);
+            }
+        }
+    }
+    free(memo->entries);
+    free(memo);
+}
+
+// Largest budget this overhang is known to yield nothing within, -1 if unknown
+int search_memo_dead_budget(SearchMemo* memo, const char* overhang, bool is_forwards) {
+    if (!memo) return -1;
+
+    MemoEntry* entry = memo_find(memo, overhang, is_forwards);
+    return entry->key ? entry->dead_budget : -1;
+}
+
+void search_memo_mark_dead(SearchMemo* memo, const char* overhang, bool is_forwards, int budget) {
+    if (!memo) return;
+
+    MemoEntry* entry = memo_upsert(memo, overhang, is_forwards);
+    if (entry && entry->dead_budget < budget) {
+        entry->dead_budget = budget;
+    }
+}
+
+IdList* search_memo_candidates(SearchMemo* memo, const char* overhang, bool is_forwards) {
+    if (!memo) return NULL;
+
+    MemoEntry* entry = memo_find(memo, overhang, is_forwards);
+    if (entry->key && entry->candidates) {
+        memo->candidate_hits++;
+        return entry->candidates;
+    }
+    return NULL;
+}
+
+bool search_memo_store_candidates(SearchMemo* memo, const char* overhang, bool is_forwards,
+                                  IdList* candidates) {
+    if (!memo || !candidates) return false;
+    if (memo->cached_words + candidates->count > memo->max_cached_words) return false;
+
+    MemoEntry* entry = memo_upsert(memo, overhang, is_forwards);
+    if (!entry || entry->candidates) return false;
+
+    entry->candidates = candidates;
+    memo->cached_words += candidates->count;
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SEARCHMEMO_H
+#define SEARCHMEMO_H
+
+#include <stdbool.h>
+#include "wordList.h"
+
+#define MEMO_DEAD_FOREVER 1000000   // budget for subtrees that end before any limit
+#define MEMO_INITIAL_CAPACITY 1024  // slots allocated before the first growth
+
+// Per-overhang knowledge kept across iterative-deepening passes
+typedef struct {
+    char* key;              // direction byte followed by the overhang
+    int dead_budget;        // largest budget known to yield no palindrome, -1 if none
+    IdList* candidates;   // cached expansion, NULL if not cached
+} MemoEntry;
+
+// Growable hash table; inserts are refused once the bounds are reached
+typedef struct {
+    MemoEntry* entries;
+    int capacity;
+    int count;
+    int max_entries;
+    long cached_words;
+    long max_cached_words;
+    long dead_hits;
+    long candidate_hits;
+} SearchMemo;
+
+SearchMemo* search_memo_create(int max_entries, long max_cached_words);
+void search_memo_destroy(SearchMemo* memo);
+
+// Dead-end knowledge
+int search_memo_dead_budget(SearchMemo* memo, const char* overhang, bool is_forwards);
+void search_memo_mark_dead(SearchMemo* memo, const char* overhang, bool is_forwards, int budget);
+
+// Candidate cache; store takes ownership of the list only when it returns true
+IdList* search_memo_candidates(SearchMemo* memo, const char* overhang, bool is_forwards);
+bool search_memo_store_candidates(SearchMemo* memo, const char* overhang, bool is_forwards,
+                                  IdList* candidates);
+
+#endif // SEARCHMEMO_H
@@ -0,0 +1,28 @@
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include <stdbool.h>
+
+#define SEARCH_PATH_MAX 7   // pieces a state can settle; at least MAX_PALINDROME_LEN + 1
+
+// The text of a word from `offset` to its end, reading the word forwards or
+// back to front. Ids from 0 up are dictionary words; ids below -1 are text
+// owned by the running query (starting words and compound starts).
+typedef struct {
+    int word_id;
+    unsigned short offset;
+    bool reversed;
+} TextRef;
+
+// Search state for iterative backtracking. The left side is kept as the
+// pieces it was settled from rather than as text; the palindrome is only
+// rendered when a result is written.
+typedef struct {
+    TextRef pieces[SEARCH_PATH_MAX];    // settled left side, one piece per word placed
+    unsigned int forwards_pieces;       // bit i set if piece i was settled going forwards
+    TextRef overhang;                   // current unmatched portion
+    unsigned char depth;                // words placed so far, and so pieces settled
+    bool is_forwards;                   // direction of current search
+} SearchState;
+
+#endif // SEARCHSTATE_H
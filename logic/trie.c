@@ -5,35 +5,130 @@
 #include <ctype.h>
 #include "trie.h"
 
+// Current alphabet; a-z until trie_set_alphabet says otherwise
+static int alphabet_size = ALPHABET_SIZE;
+static bool alphabet_is_az = true;
+static char symbols[ALPHABET_MAX] = "abcdefghijklmnopqrstuvwxyz";
+static int symbol_index[ALPHABET_MAX];     // byte -> child slot, -1 if not a symbol
+
+// Use the given distinct symbols, in byte order; false if they are unusable
+bool trie_set_alphabet(const char* new_symbols, int count) {
+    if (!new_symbols || count < 1 || count > ALPHABET_MAX) return false;
+    
+    bool used[ALPHABET_MAX] = { false };
+    for (int i = 0; i < count; i++) {
+        unsigned char c = new_symbols[i];
+        if (used[c]) return false;
+        used[c] = true;
+    }
+    
+    alphabet_size = 0;
+    for (int c = 0; c < ALPHABET_MAX; c++) {
+        symbol_index[c] = used[c] ? alphabet_size : -1;
+        if (used[c]) {
+            symbols[alphabet_size++] = (char) c;
+        }
+    }
+    alphabet_is_az = alphabet_size == ALPHABET_SIZE && symbols[0] == 'a' &&
+                     symbols[ALPHABET_SIZE - 1] == 'z';
+    return true;
+}
+
+int trie_alphabet_size(void) {
+    return alphabet_size;
+}
+
+// Get the child slot for a character, -1 if it is not in the alphabet
+static inline int c2i(char c) {
+    if (alphabet_is_az) {
+        unsigned int index = (unsigned char) c - 'a';
+        return index < ALPHABET_SIZE ? (int) index : -1;
+    }
+    return symbol_index[(unsigned char) c];
+}
+
+// Check that every character of a word is in the alphabet
+bool trie_in_alphabet(const char* word) {
+    if (!word) return false;
+    
+    for (const char* p = word; *p; p++) {
+        if (c2i(*p) == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Create a new trie node
 TrieNode* trie_node_create(void) {
-    TrieNode* node = malloc(sizeof(TrieNode));
+    TrieNode* node = malloc(sizeof(TrieNode) + sizeof(TrieNode*) * alphabet_size);
     if (!node) {
         fprintf(stderr, "Memory allocation failed for trie node\n");
         exit(1);
     }
     
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
+    for (int i = 0; i < alphabet_size; i++) {
         node->children[i] = NULL;
     }
     node->is_word_end = false;
+    node->word_id = -1;
+    node->stamp = 0;
+    node->closing_ids = NULL;
+    node->closing_count = 0;
+    node->closing_capacity = 0;
 
     return node;
 }
 
+// Free a single node (not its children)
+static void trie_node_free(TrieNode* node) {
+    free(node->closing_ids);
+    free(node);
+}
+
+// Check if the first len characters of text read the same backwards
+static bool trie_is_palindrome(const char* text, int len) {
+    for (int i = 0; i < len / 2; i++) {
+        if (text[i] != text[len - 1 - i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Record that the word with this id closes into a palindrome below node
+static void trie_closing_add(TrieNode* node, int word_id) {
+    if (node->closing_count >= node->closing_capacity) {
+        node->closing_capacity = node->closing_capacity ? node->closing_capacity * 2 : 2;
+        node->closing_ids = realloc(node->closing_ids, sizeof(int) * node->closing_capacity);
+        if (!node->closing_ids) {
+            fprintf(stderr, "Memory allocation failed for trie closing list\n");
+            exit(1);
+        }
+    }
+    node->closing_ids[node->closing_count++] = word_id;
+}
+
+static void trie_closing_remove(TrieNode* node, int word_id) {
+    for (int i = 0; i < node->closing_count; i++) {
+        if (node->closing_ids[i] == word_id) {
+            node->closing_ids[i] = node->closing_ids[--node->closing_count];
+            return;
+        }
+    }
+}
+
 // Create a new trie (returns root node)
 TrieNode* trie_create(void) {
     return trie_node_create();
 }
 
-// Get index for a character (a-z maps to 0-25)
-static int c2i(char c) {
-        return c - 'a';
-}
-
-// Insert a word into the trie
-void trie_insert(TrieNode* root, const char* word) {
-    if (!root || !word) return;
+// Insert a word into the trie, recording its id at the end node and in
+// the closing list of every node above it whose remainder of the word is a
+// palindrome; the end node's own word_id covers the empty remainder
+void trie_insert(TrieNode* root, const char* word, int word_id) {
+    if (!root || !trie_in_alphabet(word)) return;
+    if (trie_search(root, word)) return;
     
     TrieNode* current = root;
     int len = strlen(word);
@@ -41,8 +136,9 @@ void trie_insert(TrieNode* root, const char* word) {
     for (int i = 0; i < len; i++) {
         int index = c2i(word[i]);
         
-        // Skip invalid characters
-        if (index == -1) continue;
+        if (trie_is_palindrome(word + i, len - i)) {
+            trie_closing_add(current, word_id);
+        }
         
         // Create new node if it doesn't exist
         if (!current->children[index]) {
@@ -53,9 +149,8 @@ void trie_insert(TrieNode* root, const char* word) {
     }
     
     // Mark end of word
-    if (!current->is_word_end) {
-        current->is_word_end = true;
-    }
+    current->is_word_end = true;
+    current->word_id = word_id;
 }
 
 // Search for a word in the trie
@@ -78,6 +173,107 @@ bool trie_search(TrieNode* root, const char* word) {
     return current->is_word_end;
 }
 
+// Get the id of a word, or -1 if it is not in the trie
+int trie_lookup(TrieNode* root, const char* word) {
+    if (!root || !word) return -1;
+    
+    TrieNode* current = root;
+    int len = strlen(word);
+    
+    for (int i = 0; i < len; i++) {
+        int index = c2i(word[i]);
+        
+        if (index == -1 || !current->children[index]) {
+            return -1;
+        }
+        
+        current = current->children[index];
+    }
+    
+    return current->is_word_end ? current->word_id : -1;
+}
+
+// Check if a node has any children
+static bool trie_has_children(TrieNode* node) {
+    for (int i = 0; i < alphabet_size; i++) {
+        if (node->children[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Count the children of a node
+static int trie_child_count(TrieNode* node) {
+    int count = 0;
+    for (int i = 0; i < alphabet_size; i++) {
+        if (node->children[i]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Walk a word, recording the node at each depth (path needs len + 1 slots)
+static bool trie_word_path(TrieNode* root, const char* word, int len, TrieNode** path) {
+    path[0] = root;
+    
+    for (int i = 0; i < len; i++) {
+        int index = c2i(word[i]);
+        
+        if (index == -1 || !path[i]->children[index]) {
+            return false;
+        }
+        
+        path[i + 1] = path[i]->children[index];
+    }
+    
+    return path[len]->is_word_end;
+}
+
+// First depth whose node is no longer needed once the word is removed,
+// or len + 1 if the word's end node still has children
+static int trie_prune_depth(TrieNode** path, int len) {
+    if (trie_has_children(path[len])) return len + 1;
+    
+    int depth = len;
+    while (depth > 1 && !path[depth - 1]->is_word_end && trie_child_count(path[depth - 1]) == 1) {
+        depth--;
+    }
+    return depth;
+}
+
+// Remove a word from the trie, pruning nodes that no longer lead to a word
+bool trie_remove(TrieNode* root, const char* word) {
+    if (!root || !word) return false;
+    
+    int len = strlen(word);
+    TrieNode** path = malloc(sizeof(TrieNode*) * (len + 1));
+    if (!path) return false;
+    
+    if (!trie_word_path(root, word, len, path)) {
+        free(path);
+        return false;
+    }
+    
+    int depth = trie_prune_depth(path, len);
+    int keep = depth > len ? len : depth - 1;
+    for (int i = 0; i <= keep; i++) {
+        trie_closing_remove(path[i], path[len]->word_id);
+    }
+    
+    if (depth > len) {
+        path[len]->is_word_end = false;
+        path[len]->word_id = -1;
+    } else {
+        path[depth - 1]->children[c2i(word[depth - 1])] = NULL;
+        trie_destroy(path[depth]);
+    }
+    
+    free(path);
+    return true;
+}
+
 // Check if a prefix exists in the trie
 bool trie_has_prefix(TrieNode* root, const char* prefix) {
     if (!root || !prefix) return false;
@@ -98,8 +294,8 @@ bool trie_has_prefix(TrieNode* root, const char* prefix) {
     return true;
 }
 
-// Get the node corresponding to a prefix
-static TrieNode* trie_get_prefix_node(TrieNode* root, const char* prefix) {
+// Get the node corresponding to a prefix, NULL if no word starts with it
+TrieNode* trie_get_prefix_node(TrieNode* root, const char* prefix) {
     if (!root || !prefix) return NULL;
     
     TrieNode* current = root;
@@ -118,43 +314,168 @@ static TrieNode* trie_get_prefix_node(TrieNode* root, const char* prefix) {
     return current;
 }
 
-// Recursive helper for collecting words with a given prefix
-static void trie_collect_words_helper(TrieNode* node, char* current_word, 
-                                     int depth, const char* prefix, 
-                                     WordList* results) {
-    if (!node) return;
+void trie_node_list_add(TrieNodeList* list, TrieNode* node) {
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->nodes = realloc(list->nodes, sizeof(TrieNode*) * list->capacity);
+        if (!list->nodes) {
+            fprintf(stderr, "Memory allocation failed for trie node list\n");
+            exit(1);
+        }
+    }
+    list->nodes[list->count++] = node;
+}
+
+// Free the list (and, optionally, each node in it individually)
+void trie_node_list_free(TrieNodeList* list, bool free_nodes) {
+    if (free_nodes) {
+        for (int i = 0; i < list->count; i++) {
+            trie_node_free(list->nodes[i]);
+        }
+    }
+    free(list->nodes);
+    list->nodes = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+static void trie_node_list_remove(TrieNodeList* list, TrieNode* node) {
+    for (int i = list->count - 1; i >= 0; i--) {
+        if (list->nodes[i] == node) {
+            list->nodes[i] = list->nodes[--list->count];
+            return;
+        }
+    }
+}
+
+// Start a copy-on-write update with a fresh stamp
+void trie_update_init(TrieUpdate* update) {
+    static unsigned int next_stamp = 0;
     
-    // If this node marks the end of a word, add it to results
-    if (node->is_word_end) {
-        current_word[depth] = '\0';
-        char* full_word = malloc(strlen(prefix) + strlen(current_word) + 1);
-        strcpy(full_word, prefix);
-        strcat(full_word, current_word);
-        wordlist_add(results, full_word);
-        free(full_word);
+    update->stamp = __atomic_add_fetch(&next_stamp, 1, __ATOMIC_RELAXED);
+    update->created = (TrieNodeList) { NULL, 0, 0 };
+    update->replaced = (TrieNodeList) { NULL, 0, 0 };
+}
+
+// Throw away the new version built by an update
+void trie_update_discard(TrieUpdate* update) {
+    trie_node_list_free(&update->created, true);
+    trie_node_list_free(&update->replaced, false);
+}
+
+// Release the bookkeeping once the update's node lists have been taken over
+void trie_update_free(TrieUpdate* update) {
+    trie_node_list_free(&update->created, false);
+    trie_node_list_free(&update->replaced, false);
+}
+
+// Get a node the update may modify, copying it if it is shared
+static TrieNode* trie_cow_node(TrieNode* node, TrieUpdate* update) {
+    if (node->stamp == update->stamp) return node;
+    
+    TrieNode* copy = trie_node_create();
+    memcpy(copy->children, node->children, sizeof(TrieNode*) * alphabet_size);
+    copy->is_word_end = node->is_word_end;
+    copy->word_id = node->word_id;
+    copy->stamp = update->stamp;
+    if (node->closing_count > 0) {
+        copy->closing_ids = malloc(sizeof(int) * node->closing_count);
+        if (!copy->closing_ids) {
+            fprintf(stderr, "Memory allocation failed for trie closing list\n");
+            exit(1);
+        }
+        memcpy(copy->closing_ids, node->closing_ids, sizeof(int) * node->closing_count);
+        copy->closing_count = node->closing_count;
+        copy->closing_capacity = node->closing_count;
     }
     
-    // Recursively traverse all children
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i]) {
-            current_word[depth] = 'a' + i;
-            trie_collect_words_helper(node->children[i], current_word, 
-                                    depth + 1, prefix, results);
+    trie_node_list_add(&update->created, copy);
+    trie_node_list_add(&update->replaced, node);
+    return copy;
+}
+
+// Insert a word by copying the path to it
+TrieNode* trie_insert_cow(TrieNode* root, const char* word, int word_id, TrieUpdate* update) {
+    if (!root || !update || !trie_in_alphabet(word)) return root;
+    if (trie_search(root, word)) return root;
+    
+    TrieNode* new_root = trie_cow_node(root, update);
+    TrieNode* current = new_root;
+    int len = strlen(word);
+    
+    for (int i = 0; i < len; i++) {
+        int index = c2i(word[i]);
+        
+        if (trie_is_palindrome(word + i, len - i)) {
+            trie_closing_add(current, word_id);
+        }
+        
+        TrieNode* child = current->children[index];
+        if (child) {
+            child = trie_cow_node(child, update);
+        } else {
+            child = trie_node_create();
+            child->stamp = update->stamp;
+            trie_node_list_add(&update->created, child);
         }
+        
+        current->children[index] = child;
+        current = child;
     }
+    
+    current->is_word_end = true;
+    current->word_id = word_id;
+    return new_root;
 }
 
-// Get all words that start with a given prefix
-void trie_get_words_with_prefix(TrieNode* root, const char* prefix, WordList* results) {
-    if (!root || !prefix || !results) return;
+// Remove a word by copying the path to it and pruning what it leaves empty
+TrieNode* trie_remove_cow(TrieNode* root, const char* word, TrieUpdate* update) {
+    if (!root || !word || !update) return root;
     
-    // Find the node corresponding to the prefix
-    TrieNode* prefix_node = trie_get_prefix_node(root, prefix);
-    if (!prefix_node) return;
+    int len = strlen(word);
+    TrieNode** path = malloc(sizeof(TrieNode*) * (len + 1));
+    if (!path) return root;
+    
+    if (!trie_word_path(root, word, len, path)) {
+        free(path);
+        return root;
+    }
+    
+    // Copy the nodes that stay, down to the word's end or the prune point
+    int depth = trie_prune_depth(path, len);
+    int keep = depth > len ? len : depth - 1;
+    
+    int word_id = path[len]->word_id;
+    TrieNode* new_root = trie_cow_node(root, update);
+    TrieNode* current = new_root;
+    trie_closing_remove(current, word_id);
+    for (int i = 0; i < keep; i++) {
+        int index = c2i(word[i]);
+        current->children[index] = trie_cow_node(current->children[index], update);
+        current = current->children[index];
+        trie_closing_remove(current, word_id);
+    }
+    
+    if (depth > len) {
+        current->is_word_end = false;
+        current->word_id = -1;
+    } else {
+        current->children[c2i(word[depth - 1])] = NULL;
+        
+        // Pruned nodes private to this update can go now; shared ones are
+        // still visible to the old version
+        for (int i = depth; i <= len; i++) {
+            if (path[i]->stamp == update->stamp) {
+                trie_node_list_remove(&update->created, path[i]);
+                trie_node_free(path[i]);
+            } else {
+                trie_node_list_add(&update->replaced, path[i]);
+            }
+        }
+    }
     
-    // Collect all words from this node
-    char suffix[1000];  // Buffer for building suffixes
-    trie_collect_words_helper(prefix_node, suffix, 0, prefix, results);
+    free(path);
+    return new_root;
 }
 
 // Recursive helper for collecting all words in the trie
@@ -164,19 +485,33 @@ static void trie_collect_all_words_helper(TrieNode* node, char* current_word,
     
     // If this node marks the end of a word, add it to results
     if (node->is_word_end) {
-        current_word[depth] = '\0';
-        wordlist_add(results, current_word);
+        wordlist_add_n(results, current_word, depth);
     }
     
     // Recursively traverse all children
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
+    for (int i = 0; i < alphabet_size; i++) {
         if (node->children[i]) {
-            current_word[depth] = 'a' + i;
+            current_word[depth] = symbols[i];
             trie_collect_all_words_helper(node->children[i], current_word, depth + 1, results);
         }
     }
 }
 
+// Get all words that start with a given prefix
+void trie_get_words_with_prefix(TrieNode* root, const char* prefix, WordList* results) {
+    if (!root || !prefix || !results) return;
+    
+    // Find the node corresponding to the prefix
+    TrieNode* prefix_node = trie_get_prefix_node(root, prefix);
+    if (!prefix_node) return;
+    
+    // Collect all words from this node, building them after the prefix
+    char word_buffer[1000];
+    int depth = strlen(prefix);
+    memcpy(word_buffer, prefix, depth);
+    trie_collect_all_words_helper(prefix_node, word_buffer, depth, results);
+}
+
 // Get all words in the trie
 void trie_get_all_words(TrieNode* root, WordList* results) {
     if (!root || !results) return;
@@ -185,12 +520,83 @@ void trie_get_all_words(TrieNode* root, WordList* results) {
     trie_collect_all_words_helper(root, word_buffer, 0, results);
 }
 
+// Recursive helper collecting the ids of every word below a node
+static void trie_collect_ids_helper(TrieNode* node, IdList* results) {
+    if (node->is_word_end) {
+        idlist_add(results, node->word_id);
+    }
+    
+    for (int i = 0; i < alphabet_size; i++) {
+        if (node->children[i]) {
+            trie_collect_ids_helper(node->children[i], results);
+        }
+    }
+}
+
+// Get the ids of all words that start with a given prefix
+void trie_get_ids_with_prefix(TrieNode* root, const char* prefix, IdList* results) {
+    if (!root || !prefix || !results) return;
+    
+    TrieNode* prefix_node = trie_get_prefix_node(root, prefix);
+    if (!prefix_node) return;
+    
+    trie_collect_ids_helper(prefix_node, results);
+}
+
+// Recursive helper walking the trie and a trie of prefixes in lockstep
+static void trie_collect_prefixed_helper(TrieNode* node, TrieNode* prefixes, IdList* results) {
+    // Everything below the shortest matching prefix qualifies
+    if (prefixes->is_word_end) {
+        trie_collect_ids_helper(node, results);
+        return;
+    }
+    
+    for (int i = 0; i < alphabet_size; i++) {
+        if (prefixes->children[i] && node->children[i]) {
+            trie_collect_prefixed_helper(node->children[i], prefixes->children[i], results);
+        }
+    }
+}
+
+// Get the ids of every word starting with any word stored in `prefixes`, each once
+void trie_get_ids_with_prefixes(TrieNode* root, TrieNode* prefixes, IdList* results) {
+    if (!root || !prefixes || !results) return;
+    
+    trie_collect_prefixed_helper(root, prefixes, results);
+}
+
+// Find the words in the trie that are prefixes of `word` (including the
+// word itself); stores their lengths (and ids, if word_ids is not NULL),
+// shortest first, and returns the count. Both arrays need room for
+// strlen(word) + 1 entries.
+int trie_get_prefix_words(TrieNode* root, const char* word, int* lengths, int* word_ids) {
+    if (!root || !word || !lengths) return 0;
+    
+    TrieNode* current = root;
+    int count = 0;
+    int len = strlen(word);
+    
+    for (int i = 0; ; i++) {
+        if (current->is_word_end) {
+            if (word_ids) word_ids[count] = current->word_id;
+            lengths[count++] = i;
+        }
+        if (i == len) break;
+        
+        int index = c2i(word[i]);
+        if (index == -1 || !current->children[index]) break;
+        current = current->children[index];
+    }
+    
+    return count;
+}
+
 
 // Check if trie is empty
 bool trie_is_empty(TrieNode* root) {
     if (!root) return true;
     
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
+    for (int i = 0; i < alphabet_size; i++) {
         if (root->children[i]) {
             return false;
         }
@@ -209,7 +615,7 @@ void trie_print_all_words(TrieNode* root) {
     
     printf("Trie contains %d words:\n", words->count);
     for (int i = 0; i < words->count; i++) {
-        printf("  %s\n", words->words[i]);
+        printf("  %s\n", wordlist_get(words, i));
     }
     
     wordlist_free(words);
@@ -220,12 +626,12 @@ void trie_destroy(TrieNode* root) {
     if (!root) return;
     
     // Recursively destroy all children
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
+    for (int i = 0; i < alphabet_size; i++) {
         if (root->children[i]) {
             trie_destroy(root->children[i]);
         }
     }
     
     // Free the current node
-    free(root);
+    trie_node_free(root);
 }
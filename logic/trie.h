@@ -5,14 +5,36 @@
 #include "wordList.h"
 
 
-#define ALPHABET_SIZE 26
+#define ALPHABET_SIZE 26     // default alphabet: the letters a-z
+#define ALPHABET_MAX 256
 
-// Trie node structure
+// Trie node structure. Nodes have one child slot per symbol of the current
+// alphabet (see trie_set_alphabet), so they are only ever heap-allocated.
 typedef struct TrieNode {
-    struct TrieNode* children[ALPHABET_SIZE];
     bool is_word_end;
+    int word_id;            // id of the word ending here, -1 if none
+    unsigned int stamp;     // copy-on-write update that created the node, 0 if none
+    int* closing_ids;       // words strictly below whose rest after this node is a palindrome
+    int closing_count;
+    int closing_capacity;
+    struct TrieNode* children[];
 } TrieNode;
 
+// Growable list of node pointers
+typedef struct {
+    TrieNode** nodes;
+    int count;
+    int capacity;
+} TrieNodeList;
+
+// Bookkeeping for copy-on-write updates: nodes stamped with this update are
+// private to the new version and may be modified in place
+typedef struct {
+    unsigned int stamp;
+    TrieNodeList created;   // nodes only reachable from the new version
+    TrieNodeList replaced;  // nodes of the old version the new one no longer shares
+} TrieUpdate;
+
 // Statistics structure for trie analysis
 typedef struct {
     int total_nodes;
@@ -20,16 +42,40 @@ typedef struct {
     int max_depth;
 } TrieStats;
 
+// Alphabet: the symbols tries branch on, densely numbered in byte order.
+// Node size depends on it, so only change it while no trie exists. Words
+// with a byte outside the alphabet are never inserted and never found.
+bool trie_set_alphabet(const char* symbols, int count);
+int trie_alphabet_size(void);
+bool trie_in_alphabet(const char* word);
+
 // Core trie operations
 TrieNode* trie_create(void);
-void trie_insert(TrieNode* root, const char* word);
+void trie_insert(TrieNode* root, const char* word, int word_id);
 bool trie_search(TrieNode* root, const char* word);
+int trie_lookup(TrieNode* root, const char* word);
 bool trie_remove(TrieNode* root, const char* word);
 void trie_destroy(TrieNode* root);
 
+// Copy-on-write operations: return the root of the new version and leave
+// the old version untouched (returns the old root when nothing changes)
+void trie_update_init(TrieUpdate* update);
+void trie_update_discard(TrieUpdate* update);
+void trie_update_free(TrieUpdate* update);
+TrieNode* trie_insert_cow(TrieNode* root, const char* word, int word_id, TrieUpdate* update);
+TrieNode* trie_remove_cow(TrieNode* root, const char* word, TrieUpdate* update);
+
+// Node list operations
+void trie_node_list_add(TrieNodeList* list, TrieNode* node);
+void trie_node_list_free(TrieNodeList* list, bool free_nodes);
+
 // Prefix operations
 bool trie_has_prefix(TrieNode* root, const char* prefix);
+TrieNode* trie_get_prefix_node(TrieNode* root, const char* prefix);
 void trie_get_words_with_prefix(TrieNode* root, const char* prefix, WordList* results);
+void trie_get_ids_with_prefix(TrieNode* root, const char* prefix, IdList* results);
+void trie_get_ids_with_prefixes(TrieNode* root, TrieNode* prefixes, IdList* results);
+int trie_get_prefix_words(TrieNode* root, const char* word, int* lengths, int* word_ids);
 
 // Utility operations
 void trie_get_all_words(TrieNode* root, WordList* results);
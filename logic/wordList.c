@@ -1,30 +1,95 @@
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include "wordList.h"
 
+#define WORDLIST_AVG_WORD_BYTES 12
+
+static void *wordlist_realloc(void *ptr, size_t size) {
+    void *grown = realloc(ptr, size);
+    if (!grown) {
+        fprintf(stderr, "Memory allocation failed for word list\n");
+        exit(1);
+    }
+    return grown;
+}
+
 // Initialize word list
 WordList* wordlist_create(int initial_capacity) {
-    WordList* list = malloc(sizeof(WordList));
-    list->words = malloc(sizeof(char*) * initial_capacity);
+    if (initial_capacity < 1) initial_capacity = 1;
+
+    WordList* list = wordlist_realloc(NULL, sizeof(WordList));
+    list->offsets = wordlist_realloc(NULL, sizeof(int) * initial_capacity);
+    list->lengths = wordlist_realloc(NULL, sizeof(int) * initial_capacity);
+    list->pool_capacity = initial_capacity * WORDLIST_AVG_WORD_BYTES;
+    list->pool = wordlist_realloc(NULL, list->pool_capacity);
+    list->pool_used = 0;
     list->count = 0;
     list->capacity = initial_capacity;
     return list;
 }
 
-void wordlist_add(WordList* list, const char* word) {
+void wordlist_add_n(WordList* list, const char* word, int length) {
     if (list->count >= list->capacity) {
         list->capacity *= 2;
-        list->words = realloc(list->words, sizeof(char*) * list->capacity);
+        list->offsets = wordlist_realloc(list->offsets, sizeof(int) * list->capacity);
+        list->lengths = wordlist_realloc(list->lengths, sizeof(int) * list->capacity);
     }
-    list->words[list->count] = malloc(strlen(word) + 1);
-    strcpy(list->words[list->count], word);
+    if (list->pool_used + length + 1 > list->pool_capacity) {
+        while (list->pool_used + length + 1 > list->pool_capacity) {
+            list->pool_capacity *= 2;
+        }
+        list->pool = wordlist_realloc(list->pool, list->pool_capacity);
+    }
+
+    memcpy(list->pool + list->pool_used, word, length);
+    list->pool[list->pool_used + length] = '\0';
+    list->offsets[list->count] = list->pool_used;
+    list->lengths[list->count] = length;
+    list->pool_used += length + 1;
     list->count++;
 }
 
+void wordlist_add(WordList* list, const char* word) {
+    wordlist_add_n(list, word, strlen(word));
+}
+
+// Empty the list, keeping its storage for reuse
+void wordlist_reset(WordList* list) {
+    list->count = 0;
+    list->pool_used = 0;
+}
+
 void wordlist_free(WordList* list) {
-    for (int i = 0; i < list->count; i++) {
-        free(list->words[i]);
+    free(list->pool);
+    free(list->offsets);
+    free(list->lengths);
+    free(list);
+}
+
+IdList* idlist_create(int initial_capacity) {
+    if (initial_capacity < 1) initial_capacity = 1;
+
+    IdList* list = wordlist_realloc(NULL, sizeof(IdList));
+    list->ids = wordlist_realloc(NULL, sizeof(int) * initial_capacity);
+    list->count = 0;
+    list->capacity = initial_capacity;
+    return list;
+}
+
+void idlist_add(IdList* list, int id) {
+    if (list->count >= list->capacity) {
+        list->capacity *= 2;
+        list->ids = wordlist_realloc(list->ids, sizeof(int) * list->capacity);
     }
-    free(list->words);
+    list->ids[list->count++] = id;
+}
+
+void idlist_reset(IdList* list) {
+    list->count = 0;
+}
+
+void idlist_free(IdList* list) {
+    free(list->ids);
     free(list);
-}
\ No newline at end of file
+}
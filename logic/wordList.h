@@ -1,14 +1,43 @@
 #ifndef WORDLIST_H
 #define WORDLIST_H
 
+// Words packed into one byte pool: adding a word is a copy into the pool,
+// reset is O(1) and free releases everything at once
 typedef struct {
-    char **words;
+    char  *pool;         /* word bytes, each NUL-terminated */
+    int    pool_used;
+    int    pool_capacity;
+    int   *offsets;      /* start of each word in the pool */
+    int   *lengths;
     int    count;
     int    capacity;
 } WordList;
 
 WordList *wordlist_create(int initial_capacity);
 void       wordlist_add  (WordList *list, const char *word);
+void       wordlist_add_n(WordList *list, const char *word, int length);
+void       wordlist_reset(WordList *list);
 void       wordlist_free (WordList *list);
 
+/* Pointers stay valid until the next add, reset or free */
+static inline const char *wordlist_get(const WordList *list, int index) {
+    return list->pool + list->offsets[index];
+}
+
+static inline int wordlist_length(const WordList *list, int index) {
+    return list->lengths[index];
+}
+
+/* Growable list of word ids, for walks that never need the text */
+typedef struct {
+    int   *ids;
+    int    count;
+    int    capacity;
+} IdList;
+
+IdList    *idlist_create(int initial_capacity);
+void       idlist_add   (IdList *list, int id);
+void       idlist_reset (IdList *list);
+void       idlist_free  (IdList *list);
+
 #endif /* WORDLIST_H */
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "wordTable.h"
+
+WordTable* word_table_create(void) {
+    WordTable* table = calloc(1, sizeof(WordTable));
+    return table;
+}
+
+void word_table_destroy(WordTable* table) {
+    if (!table) return;
+
+    for (int i = 0; i < WORD_TABLE_MAX_SEGMENTS; i++) {
+        free(table->segments[i]);
+    }
+    for (int i = 0; i < table->chunk_count; i++) {
+        free(table->chunks[i]);
+    }
+    free(table->chunks);
+    free(table->lookup);
+    free(table);
+}
+
+// FNV-1a over the word's bytes
+static unsigned int word_table_hash(const char* word, int length) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char) word[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Lookup slot holding the word, or the empty slot where it would go
+static int* word_table_slot(const WordTable* table, const char* word, int length) {
+    unsigned int mask = table->lookup_capacity - 1;
+    unsigned int index = word_table_hash(word, length) & mask;
+
+    for (;;) {
+        int* slot = &table->lookup[index];
+        if (*slot == 0) return slot;
+
+        int id = *slot - 1;
+        if (word_table_length(table, id) == length &&
+            memcmp(word_table_get(table, id), word, length) == 0) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+// Make room for one more word at a load factor of at most one half
+static bool word_table_reserve_lookup(WordTable* table) {
+    if ((table->count + 1) * 2 <= table->lookup_capacity) return true;
+
+    int capacity = table->lookup_capacity ? table->lookup_capacity * 2 : 1024;
+    int* lookup = calloc(capacity, sizeof(int));
+    if (!lookup) return false;
+
+    int* old_lookup = table->lookup;
+    table->lookup = lookup;
+    table->lookup_capacity = capacity;
+    for (int id = 0; id < table->count; id++) {
+        *word_table_slot(table, word_table_get(table, id), word_table_length(table, id)) = id + 1;
+    }
+    free(old_lookup);
+    return true;
+}
+
+int word_table_find(const WordTable* table, const char* word, int length) {
+    if (table->lookup_capacity == 0) return -1;
+    return *word_table_slot(table, word, length) - 1;
+}
+
+// Start a new chunk big enough for at least `needed` bytes
+static char* word_table_new_chunk(WordTable* table, int needed) {
+    int capacity = needed > WORD_TABLE_CHUNK_BYTES ? needed : WORD_TABLE_CHUNK_BYTES;
+    char* chunk = malloc(capacity);
+    if (!chunk) return NULL;
+
+    if (table->chunk_count >= table->chunks_capacity) {
+        int chunks_capacity = table->chunks_capacity ? table->chunks_capacity * 2 : 16;
+        char** chunks = realloc(table->chunks, sizeof(char*) * chunks_capacity);
+        if (!chunks) {
+            free(chunk);
+            return NULL;
+        }
+        table->chunks = chunks;
+        table->chunks_capacity = chunks_capacity;
+    }
+
+    table->chunks[table->chunk_count++] = chunk;
+    table->chunk = chunk;
+    table->chunk_used = 0;
+    table->chunk_capacity = capacity;
+    return chunk;
+}
+
+int word_table_add(WordTable* table, const char* word, int length) {
+    int id = table->count;
+    int segment = id / WORD_TABLE_SEGMENT_SIZE;
+    if (segment >= WORD_TABLE_MAX_SEGMENTS) return -1;
+
+    if (!table->segments[segment]) {
+        table->segments[segment] = malloc(sizeof(WordEntry) * WORD_TABLE_SEGMENT_SIZE);
+        if (!table->segments[segment]) return -1;
+    }
+    if (!word_table_reserve_lookup(table)) return -1;
+
+    if (!table->chunk || table->chunk_used + length + 1 > table->chunk_capacity) {
+        if (!word_table_new_chunk(table, length + 1)) return -1;
+    }
+
+    char* text = table->chunk + table->chunk_used;
+    memcpy(text, word, length);
+    text[length] = '\0';
+    table->chunk_used += length + 1;
+
+    WordEntry* entry = &table->segments[segment][id % WORD_TABLE_SEGMENT_SIZE];
+    entry->text = text;
+    entry->length = length;
+    table->count++;
+    *word_table_slot(table, text, length) = id + 1;
+    return id;
+}
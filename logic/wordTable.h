@@ -0,0 +1,49 @@
+#ifndef WORDTABLE_H
+#define WORDTABLE_H
+
+#define WORD_TABLE_SEGMENT_SIZE 65536      // ids per index segment
+#define WORD_TABLE_MAX_SEGMENTS 1024
+#define WORD_TABLE_CHUNK_BYTES (1 << 20)
+
+// Text and length of one interned word
+typedef struct {
+    const char* text;
+    int length;
+} WordEntry;
+
+// Append-only table of interned dictionary words, addressed by id. Word
+// bytes live in large chunks and the index in fixed segments, so nothing
+// moves when the table grows and readers never need a lock. Adds and finds
+// must be serialised by the caller; a hash of the texts lets a word that
+// comes back get its old id instead of a new entry.
+typedef struct {
+    WordEntry* segments[WORD_TABLE_MAX_SEGMENTS];
+    int count;
+    char* chunk;            // chunk currently being filled
+    int chunk_used;
+    int chunk_capacity;
+    char** chunks;          // every chunk, for freeing
+    int chunk_count;
+    int chunks_capacity;
+    int* lookup;            // open-addressed hash of id + 1, 0 for empty
+    int lookup_capacity;
+} WordTable;
+
+WordTable* word_table_create(void);
+void word_table_destroy(WordTable* table);
+
+// Returns the new word's id, or -1 if the table is full
+int word_table_add(WordTable* table, const char* word, int length);
+
+// Id of a word already interned, -1 if it never was
+int word_table_find(const WordTable* table, const char* word, int length);
+
+static inline const char* word_table_get(const WordTable* table, int id) {
+    return table->segments[id / WORD_TABLE_SEGMENT_SIZE][id % WORD_TABLE_SEGMENT_SIZE].text;
+}
+
+static inline int word_table_length(const WordTable* table, int id) {
+    return table->segments[id / WORD_TABLE_SEGMENT_SIZE][id % WORD_TABLE_SEGMENT_SIZE].length;
+}
+
+#endif // WORDTABLE_H
@@ -6,7 +6,65 @@
 #include "logic/wordList.h"
 #include "logic/Cpalindromer.h"
 
-int main() {
+// Progress report for shortest-first mode
+static bool report_level(int word_count, int found, void* context) {
+    (void) context;
+    printf("--- %d-word palindromes: %d ---\n", word_count, found);
+    return true;
+}
+
+// Read seeds until end of input and search them as one batch
+static int run_batch(void) {
+    int capacity = 64;
+    int seed_count = 0;
+    char (*seeds)[MAX_WORD_LEN] = malloc(sizeof(*seeds) * capacity);
+    char seed[MAX_WORD_LEN];
+    
+    printf("seeds (end with EOF): ");
+    while (seeds && scanf("%99s", seed) == 1) {
+        if (seed_count >= capacity) {
+            capacity *= 2;
+            seeds = realloc(seeds, sizeof(*seeds) * capacity);
+            if (!seeds) break;
+        }
+        for (int i = 0; seed[i]; i++) {
+            seed[i] = tolower((unsigned char) seed[i]);
+        }
+        if (seed[0] == '0') {
+            seed[0] = '\0';
+        }
+        strcpy(seeds[seed_count++], seed);
+    }
+    if (!seeds) {
+        printf("Error: Out of memory reading seeds\n");
+        return 0;
+    }
+    
+    const char** seed_list = malloc(sizeof(char*) * (seed_count + 1));
+    int* counts = malloc(sizeof(int) * (seed_count + 1));
+    for (int i = 0; i < seed_count; i++) {
+        seed_list[i] = seeds[i];
+    }
+    
+    printf("Searching for palindromes from %d seeds...\n", seed_count);
+    int count = palindrome_find_batch(seed_list, seed_count, counts);
+    
+    printf("\n");
+    for (int i = 0; i < seed_count; i++) {
+        printf("'%s': %d\n", seed_list[i], counts[i]);
+    }
+    
+    free(counts);
+    free(seed_list);
+    free(seeds);
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    // "-s" searches shortest-first, "-b" searches a batch of seeds
+    bool shortest_first = argc > 1 && strcmp(argv[1], "-s") == 0;
+    bool batch = argc > 1 && strcmp(argv[1], "-b") == 0;
+
     // Initialize palindrome finder
     if (!palindrome_init()) {
         printf("Error: Failed to initialize palindrome finder\n");
@@ -34,6 +92,14 @@ int main() {
         return 1;
     }
     
+    if (batch) {
+        int count = run_batch();
+        printf("\nFound %d palindromes total\n", count);
+        palindrome_print_output_stats();
+        palindrome_cleanup();
+        return 0;
+    }
+    
     // Get starting word
     char attempt[MAX_WORD_LEN];
     printf("start: ");
@@ -41,16 +107,22 @@ int main() {
     
     // Convert to lowercase
     for (int i = 0; attempt[i]; i++) {
-        attempt[i] = tolower(attempt[i]);
+        attempt[i] = tolower((unsigned char) attempt[i]);
     }
     if (attempt[0] == '0') {
         attempt[0] = '\0';
     }
     // Find palindromes
     printf("Searching for palindromes starting with '%s'...\n", attempt);
-    int count = palindrome_find_all(attempt);
+    int count;
+    if (shortest_first) {
+        count = palindrome_find_shortest_first(attempt, report_level, NULL);
+    } else {
+        count = palindrome_find_all(attempt);
+    }
     
     printf("\nFound %d palindromes total\n", count);
+    palindrome_print_output_stats();
     
     // Cleanup
     palindrome_cleanup();